@@ -0,0 +1,101 @@
+
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <chrono>
+#include <fcntl.h>
+#include "MyDB_AttType.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_Schema.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// these are little helpers shared by all of the buffer manager benchmarks
+
+// the schema of the supplier table
+inline MyDB_SchemaPtr supplierSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+	mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+	return mySchema;
+}
+
+// creates the table tableName in the file storageLoc and loads the text file fromMe into it,
+// using a throw-away buffer manager... returns the table, which has its last page set
+inline MyDB_TablePtr loadSupplier (string tableName, string storageLoc, string fromMe, size_t pageSize) {
+	MyDB_TablePtr myTable = make_shared <MyDB_Table> (tableName, storageLoc, supplierSchema ());
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 128, "benchTempFile");
+	MyDB_TableReaderWriter loadMe (myTable, myMgr);
+	loadMe.loadFromTextFile (fromMe);
+	return myTable;
+}
+
+// asks the OS to forget the cached pages of the file, so that a scan really goes to disk
+inline void dropFromCache (string fName) {
+	int fd = open (fName.c_str (), O_RDONLY);
+	fdatasync (fd);
+	posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+	close (fd);
+}
+
+// the number of bytes of the file that are sitting in the OS page cache
+inline size_t cachedBytes (string fName) {
+	int fd = open (fName.c_str (), O_RDONLY);
+	struct stat info;
+	if (fd == -1 || fstat (fd, &info) != 0 || info.st_size == 0) {
+		if (fd != -1)
+			close (fd);
+		return 0;
+	}
+	void *mem = mmap (nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close (fd);
+	if (mem == MAP_FAILED)
+		return 0;
+	size_t osPageSize = sysconf (_SC_PAGESIZE);
+	vector <unsigned char> resident ((info.st_size + osPageSize - 1) / osPageSize);
+	size_t total = 0;
+	if (mincore (mem, info.st_size, resident.data ()) == 0) {
+		for (unsigned char r : resident)
+			total += (r & 1) * osPageSize;
+	}
+	munmap (mem, info.st_size);
+	return total;
+}
+
+// a simple wall-clock stopwatch
+class BenchTimer {
+
+public:
+
+	BenchTimer () {
+		reset ();
+	}
+
+	void reset () {
+		start = chrono :: steady_clock :: now ();
+	}
+
+	// seconds since the last reset
+	double elapsed () {
+		return chrono :: duration <double> (chrono :: steady_clock :: now () - start).count ();
+	}
+
+private:
+
+	chrono :: steady_clock :: time_point start;
+};
+
+#endif
@@ -0,0 +1,75 @@
+
+#ifndef ADVANCE_BENCH_C
+#define ADVANCE_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableRecIteratorAlt.h"
+
+using namespace std;
+
+// the number of times that each loop is run; the best time is reported
+#define NUM_RUNS 5
+
+// gets a page from the table (a page handle and a page reader/writer) for every page,
+// without looking at any records
+static size_t walkPages (MyDB_TableReaderWriter &walkMe) {
+	size_t sum = 0;
+	for (int i = 0; i < walkMe.getNumPages (); i++)
+		sum += (size_t) walkMe[i].getType ();
+	return sum;
+}
+
+// scans the table with the table iterator, so that every page costs the iterator a new
+// page, a pin, and an unpin
+static size_t scan (MyDB_TableReaderWriter &scanMe, MyDB_RecordPtr temp) {
+	size_t counter = 0;
+	MyDB_RecordIteratorAltPtr myIter = scanMe.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		counter++;
+	}
+	return counter;
+}
+
+// measures what it costs MyDB_TableRecIteratorAlt :: advance to move from one page to the
+// next, by scanning a table with small pages that are all buffered, so that no I/O is done.
+// Usage: advanceBench [file.tbl] [pageSize]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t pageSize = 4096;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		pageSize = atoi (argv[2]);
+
+	MyDB_TablePtr myTable = loadSupplier ("supplier", "supplierBench.bin", fName, pageSize);
+	size_t numFrames = myTable->lastPage () + 64;
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile");
+	MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+	size_t numPages = supplierTable.getNumPages ();
+	MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+
+	// warm up, so that every page is buffered
+	size_t sink = walkPages (supplierTable);
+
+	double bestWalk = 1e9, bestScan = 1e9;
+	size_t counter = 0;
+	for (int run = 0; run < NUM_RUNS; run++) {
+		BenchTimer timer;
+		sink += walkPages (supplierTable);
+		bestWalk = min (bestWalk, timer.elapsed ());
+		timer.reset ();
+		counter = scan (supplierTable, temp);
+		bestScan = min (bestScan, timer.elapsed ());
+	}
+
+	cout << numPages << " pages of " << pageSize << " bytes, " << counter << " records\n";
+	cout << "get page:      " << bestWalk * 1e9 / numPages << " ns per page\n";
+	cout << "iterator scan: " << bestScan * 1e9 / numPages << " ns per page, "
+		<< bestScan * 1e9 / counter << " ns per record\n";
+	cout << "(checksum " << sink << ")\n";
+}
+
+#endif
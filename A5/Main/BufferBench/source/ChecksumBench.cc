@@ -0,0 +1,88 @@
+
+#ifndef CHECKSUM_BENCH_C
+#define CHECKSUM_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_Checksum.h"
+#include "MyDB_PageReaderWriter.h"
+#include <cstdlib>
+
+using namespace std;
+
+// the number of times that each scan is run; the best time is reported
+#define NUM_RUNS 5
+
+// scans the whole table, returning the number of records
+static size_t scan (MyDB_TableReaderWriter &scanMe, MyDB_RecordPtr temp) {
+	size_t counter = 0;
+	MyDB_RecordIteratorAltPtr myIter = scanMe.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		counter++;
+	}
+	return counter;
+}
+
+// measures what page checksums cost: first the raw CRC32C speed, with the hardware instructions
+// and without, and then a scan of a table (written with checksums) that is in the OS cache but
+// not in the buffer, so that every page is read and (with checksums on) checked.
+// Usage: checksumBench [file.tbl] [pageSize]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t pageSize = 131072;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		pageSize = atoi (argv[2]);
+
+	// the raw speed, over pages that are all in cache
+	vector <char> pages (pageSize * 64);
+	for (char &c : pages)
+		c = rand ();
+	uint32_t sink = 0;
+	cout << "CRC32C over " << pageSize << "-byte pages (" << (hasHardwareCRC32C () ? "hardware" : "no hardware") << " CRC on this machine):\n";
+	for (bool hardware : {true, false}) {
+		BenchTimer timer;
+		size_t numBytes = 0;
+		while (timer.elapsed () < 1.0) {
+			for (size_t i = 0; i < 64; i++)
+				sink ^= hardware ? crc32c (0, &pages[i * pageSize], pageSize) : crc32cSoftware (0, &pages[i * pageSize], pageSize);
+			numBytes += pages.size ();
+		}
+		cout << (hardware ? "  crc32c:         " : "  crc32cSoftware: ") << numBytes / timer.elapsed () / 1e9 << " GB/s\n";
+	}
+
+	// load the table with checksums on, so that every page has one
+	MyDB_TablePtr myTable = make_shared <MyDB_Table> ("supplier", "supplierBench.bin", supplierSchema ());
+	{
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 128, "benchTempFile");
+		myMgr->setPageChecksums (true);
+		MyDB_TableReaderWriter loadMe (myTable, myMgr);
+		loadMe.loadFromTextFile (fName);
+	}
+
+	// and scan it with a buffer that is too small to hold it
+	double best[2] = {1e9, 1e9};
+	size_t counter = 0;
+	for (int run = 0; run < NUM_RUNS; run++) {
+		for (bool checksums : {false, true}) {
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 64, "benchTempFile");
+			myMgr->setPageChecksums (checksums);
+			MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+			BenchTimer timer;
+			counter = scan (supplierTable, temp);
+			best[checksums] = min (best[checksums], timer.elapsed ());
+		}
+	}
+	size_t numBytes = (myTable->lastPage () + 1) * pageSize;
+	cout << "warm scan of " << counter << " records (" << numBytes / (1024 * 1024) << "MB):\n";
+	cout << "  without checksums: " << best[0] << "s (" << numBytes / best[0] / 1e9 << " GB/s)\n";
+	cout << "  with checksums:    " << best[1] << "s (" << numBytes / best[1] / 1e9 << " GB/s), "
+		<< 100.0 * (best[1] - best[0]) / best[0] << "% slower\n";
+	cout << "(checksum " << sink << ")\n";
+	unlink ("supplierBench.bin");
+}
+
+#endif
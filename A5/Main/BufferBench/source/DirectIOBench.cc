@@ -0,0 +1,54 @@
+
+#ifndef DIRECT_IO_BENCH_C
+#define DIRECT_IO_BENCH_C
+
+#include "BenchUtils.h"
+#include "RecordComparator.h"
+#include "Sorting.h"
+
+using namespace std;
+
+// runs the sort from the sort unit tests (the big supplier table, sorted on acctbal with
+// runs of 64 pages) from a cold start, once with buffered I/O and once with O_DIRECT, and
+// reports the time along with how much of the input and output files ends up in the OS page
+// cache on top of our own buffer.  Usage: directIOBench [file.tbl] [numFrames]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t numFrames = 128;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		numFrames = atoi (argv[2]);
+
+	size_t pageSize = 131072;
+	MyDB_TablePtr myTable = loadSupplier ("supplier", "supplierBench.bin", fName, pageSize);
+
+	for (bool directIO : {false, true}) {
+
+		dropFromCache ("supplierBench.bin");
+		unlink ("sortedBench.bin");
+		{
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile",
+				MyDB_ReplacementType :: LRUReplacement, directIO);
+			MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+			MyDB_TablePtr outTable = make_shared <MyDB_Table> ("sorted", "sortedBench.bin", supplierSchema ());
+			MyDB_TableReaderWriter outputTable (outTable, myMgr);
+
+			MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+			MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+			function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+
+			BenchTimer timer;
+			sort (64, supplierTable, outputTable, myComp, rec1, rec2);
+			double sortTime = timer.elapsed ();
+			cout << (directIO && myMgr->usesDirectIO () ? "O_DIRECT: " : "buffered: ") << "sorted "
+				<< supplierTable.getNumPages () << " pages in " << sortTime << " seconds; OS cache holds "
+				<< cachedBytes ("supplierBench.bin") / 1048576.0 << " MB of the input, "
+				<< cachedBytes ("sortedBench.bin") / 1048576.0 << " MB of the output (our buffer is "
+				<< numFrames * pageSize / 1048576.0 << " MB)\n";
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,97 @@
+
+#ifndef LOG_BENCH_C
+#define LOG_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_LogManager.h"
+#include <cstdlib>
+#include <thread>
+
+using namespace std;
+
+// the number of times that each load is run; the best time is reported
+#define NUM_RUNS 3
+
+// the number of threads that commit at once, and the number of commits that each one does
+#define NUM_COMMITTERS 8
+#define COMMITS_PER_THREAD 200
+
+// loads the text file into a fresh table, with the log (if there is one) committed at the end,
+// and returns the number of seconds taken, including getting the table to disk
+static double load (string fName, size_t pageSize, MyDB_LogManagerPtr myLog) {
+	unlink ("supplierBench.bin");
+	MyDB_TablePtr myTable = make_shared <MyDB_Table> ("supplier", "supplierBench.bin", supplierSchema ());
+	BenchTimer timer;
+	{
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 128, "benchTempFile");
+		myMgr->setLog (myLog);
+		MyDB_TableReaderWriter loadMe (myTable, myMgr);
+		loadMe.loadFromTextFile (fName);
+		if (myLog != nullptr)
+			myLog->commit ();
+	}
+	return timer.elapsed ();
+}
+
+// measures what the write-ahead log costs a bulk load (the log is committed once, at the end
+// of the load, but it is written whenever its buffer fills up or an evicted page needs it),
+// how long it takes to recover from that log, and how many commits from many threads at once
+// share each write of the log.  Usage: logBench [file.tbl] [pageSize]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t pageSize = 131072;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		pageSize = atoi (argv[2]);
+
+	double best[2] = {1e9, 1e9};
+	size_t numFlushes = 0, numBytes = 0;
+	for (int run = 0; run < NUM_RUNS; run++) {
+		best[0] = min (best[0], load (fName, pageSize, nullptr));
+		unlink ("benchLog");
+		MyDB_LogManagerPtr myLog = make_shared <MyDB_LogManager> ("benchLog", pageSize);
+		best[1] = min (best[1], load (fName, pageSize, myLog));
+		numFlushes = myLog->getNumFlushes ();
+		numBytes = myLog->getNumBytesWritten ();
+	}
+	cout << "loading " << fName << ":\n";
+	cout << "  without a log: " << best[0] << "s\n";
+	cout << "  with a log:    " << best[1] << "s, " << 100.0 * (best[1] - best[0]) / best[0] << "% slower ("
+		<< numBytes / (1024 * 1024) << "MB of log in " << numFlushes << " writes)\n";
+
+	// the log from the last load is still there, since it was never checkpointed
+	{
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("benchCatalog");
+		MyDB_LogManagerPtr myLog = make_shared <MyDB_LogManager> ("benchLog", pageSize);
+		BenchTimer timer;
+		size_t numRedone = myLog->recover (myCatalog, false);
+		cout << "recovering from that log: " << numRedone << " records in " << timer.elapsed () << "s\n";
+	}
+
+	// and lots of little commits, from many threads at once
+	unlink ("benchLog");
+	MyDB_LogManagerPtr myLog = make_shared <MyDB_LogManager> ("benchLog", pageSize);
+	BenchTimer timer;
+	vector <thread> committers;
+	for (int i = 0; i < NUM_COMMITTERS; i++) {
+		committers.push_back (thread ([&myLog, i] () {
+			for (int j = 0; j < COMMITS_PER_THREAD; j++) {
+				myLog->logCatalog ("key" + to_string (i), to_string (j));
+				myLog->commit ();
+			}
+		}));
+	}
+	for (auto &committer : committers)
+		committer.join ();
+	size_t numCommits = NUM_COMMITTERS * COMMITS_PER_THREAD;
+	cout << numCommits << " commits from " << NUM_COMMITTERS << " threads: " << numCommits / timer.elapsed () << " commits/s, "
+		<< myLog->getNumFlushes () << " writes of the log (" << (double) numCommits / myLog->getNumFlushes () << " commits per write)\n";
+
+	unlink ("supplierBench.bin");
+	unlink ("benchLog");
+	unlink ("benchCatalog");
+}
+
+#endif
@@ -0,0 +1,53 @@
+
+#ifndef MAPPED_SCAN_BENCH_C
+#define MAPPED_SCAN_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_TableRecIteratorAlt.h"
+
+using namespace std;
+
+// scans the whole table with the table iterator; returns the number of records
+static size_t scan (MyDB_TableReaderWriter &scanMe, MyDB_RecordPtr temp) {
+	size_t counter = 0;
+	MyDB_RecordIteratorAltPtr myIter = scanMe.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		counter++;
+	}
+	return counter;
+}
+
+// times a full scan of a big table read through the buffer (a copy of every page into a
+// frame) and through a read-only mapping of the file, both cold and warm in the OS cache.
+// Usage: mappedScanBench [file.tbl] [numFrames]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t numFrames = 64;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		numFrames = atoi (argv[2]);
+
+	size_t pageSize = 65536;
+	MyDB_TablePtr myTable = loadSupplier ("supplier", "supplierBench.bin", fName, pageSize);
+
+	for (bool readOnly : {false, true}) {
+		for (bool cold : {true, false}) {
+			if (cold)
+				dropFromCache ("supplierBench.bin");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile");
+			MyDB_TableReaderWriter supplierTable (myTable, myMgr, readOnly);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+
+			BenchTimer timer;
+			size_t counter = scan (supplierTable, temp);
+			cout << (cold ? "cold" : "warm") << (readOnly ? ", mapped:   " : ", buffered: ")
+				<< counter << " records in " << timer.elapsed () << " seconds ("
+				<< myMgr->getNumMisses () << " page reads)\n";
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,110 @@
+
+#ifndef PAGE_TABLE_BENCH_C
+#define PAGE_TABLE_BENCH_C
+
+#include "BenchUtils.h"
+#include <map>
+#include "MyDB_Page.h"
+#include "MyDB_PageReaderWriter.h"
+#include "OpenHashTable.h"
+#include "PageCompare.h"
+#include "TableCompare.h"
+#include <vector>
+
+using namespace std;
+
+// compares the hashed page table used by the buffer manager against the pair of ordered maps
+// (fds and allPages) that it used to use, on the stream of page lookups that is made by a full
+// scan of the 320k-record supplier table.  Usage: pageTableBench [file.tbl]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	if (argc > 1)
+		fName = argv[1];
+
+	MyDB_TablePtr myTable = loadSupplier ("supplier", "supplierBench.bin", fName, 131072);
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "benchTempFile");
+	MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+	MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+
+	// first, time a real scan through the buffer manager
+	BenchTimer timer;
+	MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+	size_t counter = 0;
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		counter++;
+	}
+	cout << "scanned " << counter << " records on " << supplierTable.getNumPages () << " pages in "
+		<< timer.elapsed () << " seconds\n";
+
+	// now, rebuild the page lookup stream of that scan... MyDB_TableRecIteratorAlt::advance
+	// asks for the current page once per record, plus once more when it runs off of the page
+	vector <size_t> stream;
+	for (int i = 0; i < supplierTable.getNumPages (); i++) {
+		MyDB_RecordIteratorAltPtr pageIter = supplierTable[i].getIteratorAlt ();
+		stream.push_back (i);
+		while (pageIter->advance ()) {
+			pageIter->getCurrent (temp);
+			stream.push_back (i);
+		}
+	}
+
+	// set up the old maps and the new hash tables with one page object per page in the file
+	map <MyDB_TablePtr, int, TableCompare> oldFds;
+	map <pair <MyDB_TablePtr, size_t>, MyDB_PagePtr, PageCompare> oldPages;
+	OpenHashTable <size_t> newSlots;
+	OpenHashTable <MyDB_PagePtr> newPages;
+	oldFds[myTable] = 0;
+	newSlots.insert ((uint64_t) myTable.get (), 1);
+	for (int i = 0; i < supplierTable.getNumPages (); i++) {
+		MyDB_PagePtr page = make_shared <MyDB_Page> (myTable, i, *myMgr);
+		oldPages[make_pair (myTable, (size_t) i)] = page;
+
+		// this is the same key that the buffer manager uses for page i of slot 1
+		newPages.insert ((((uint64_t) 1) << 40) | i, page);
+	}
+
+	// replay the stream against each, the way that getPage does its lookups
+	const int numReps = 20;
+	size_t sink = 0;
+
+	timer.reset ();
+	for (int rep = 0; rep < numReps; rep++) {
+		for (size_t i : stream) {
+			if (oldFds.count (myTable) == 0)
+				exit (1);
+			pair <MyDB_TablePtr, size_t> whichPage = make_pair (myTable, i);
+			if (oldPages.count (whichPage) == 0)
+				exit (1);
+			sink += (size_t) oldPages[whichPage].get ();
+		}
+	}
+	double mapTime = timer.elapsed ();
+
+	timer.reset ();
+	for (int rep = 0; rep < numReps; rep++) {
+		for (size_t i : stream) {
+			size_t *slot = newSlots.find ((uint64_t) myTable.get ());
+			if (slot == nullptr)
+				exit (1);
+			MyDB_PagePtr *page = newPages.find ((((uint64_t) *slot) << 40) | i);
+			if (page == nullptr)
+				exit (1);
+			sink -= (size_t) page->get ();
+		}
+	}
+	double hashTime = timer.elapsed ();
+
+	// report the results
+	double numLookups = (double) stream.size () * numReps;
+	cout << "replayed " << stream.size () << " lookups " << numReps << " times\n";
+	cout << "ordered maps:       " << mapTime * 1e9 / numLookups << " ns per lookup\n";
+	cout << "hashed page table:  " << hashTime * 1e9 / numLookups << " ns per lookup\n";
+	cout << "speedup:            " << mapTime / hashTime << "x\n";
+
+	// sink should come back to zero, and printing it keeps the loops from being optimized away
+	cout << "(checksum " << sink << ")\n";
+}
+
+#endif
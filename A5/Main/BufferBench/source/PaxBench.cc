@@ -0,0 +1,82 @@
+
+#ifndef PAX_BENCH_C
+#define PAX_BENCH_C
+
+#include "BenchUtils.h"
+#include <cstdlib>
+#include <iomanip>
+
+using namespace std;
+
+// the number of times that each scan is run; the best time is reported
+#define NUM_RUNS 3
+
+// loads the text file into a fresh table of the given file type, and returns the table
+static MyDB_TablePtr load (string fName, string storageLoc, string fileType, size_t pageSize) {
+	unlink (storageLoc.c_str ());
+	MyDB_TablePtr myTable = make_shared <MyDB_Table> ("supplier", storageLoc, supplierSchema (), fileType, "");
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 128, "benchTempFile");
+	MyDB_TableReaderWriter loadMe (myTable, myMgr);
+	BenchTimer timer;
+	loadMe.loadFromTextFile (fName);
+	cout << "  loaded the " << fileType << " table in " << timer.elapsed () << "s\n";
+	return myTable;
+}
+
+// sums acctbal over the whole table, reading either every attribute or just acctbal (on row
+// pages, that is done by giving the record a projection), and returns the best time; the sum
+// goes into total
+static double sumBalances (MyDB_TablePtr myTable, size_t pageSize, bool projected, double &total) {
+	double best = 1e9;
+	for (int run = 0; run < NUM_RUNS; run++) {
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 64, "benchTempFile");
+		MyDB_TableReaderWriter scanMe (myTable, myMgr);
+		MyDB_RecordPtr temp = scanMe.getEmptyRecord ();
+		if (projected)
+			temp->setProjection (vector <int> {5});
+		BenchTimer timer;
+		MyDB_RecordIteratorAltPtr myIter = projected ? scanMe.getIteratorAlt (vector <int> {5}) : scanMe.getIteratorAlt ();
+		total = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			total += temp->getAtt (5)->toDouble ();
+		}
+		best = min (best, timer.elapsed ());
+	}
+	return best;
+}
+
+// compares a table stored in PAX pages with the same table in the usual row pages: how much
+// space each one takes, and how long it takes to scan one narrow column of it, reading the
+// whole record or only that column.  Usage: paxBench [file.tbl] [pageSize]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t pageSize = 65536;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		pageSize = atoi (argv[2]);
+
+	cout << "loading " << fName << ":\n";
+	MyDB_TablePtr heapTable = load (fName, "supplierBench.bin", "heap", pageSize);
+	MyDB_TablePtr paxTable = load (fName, "supplierPax.bin", "pax", pageSize);
+	cout << "  " << heapTable->lastPage () + 1 << " row pages, " << paxTable->lastPage () + 1 << " PAX pages\n";
+
+	cout << "summing acctbal:\n" << setprecision (15);
+	double total;
+	double rowTime = sumBalances (heapTable, pageSize, false, total);
+	cout << "  row pages, whole records:   " << rowTime << "s (sum " << total << ")\n";
+	rowTime = sumBalances (heapTable, pageSize, true, total);
+	cout << "  row pages, projected:       " << rowTime << "s (sum " << total << ")\n";
+	double paxTime = sumBalances (paxTable, pageSize, false, total);
+	cout << "  PAX pages, whole records:   " << paxTime << "s (sum " << total << ")\n";
+	paxTime = sumBalances (paxTable, pageSize, true, total);
+	cout << "  PAX pages, projected:       " << paxTime << "s (sum " << total << "), "
+		<< rowTime / paxTime << "x as fast as the row pages\n";
+
+	unlink ("supplierBench.bin");
+	unlink ("supplierPax.bin");
+}
+
+#endif
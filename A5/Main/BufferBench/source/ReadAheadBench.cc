@@ -0,0 +1,57 @@
+
+#ifndef READ_AHEAD_BENCH_C
+#define READ_AHEAD_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableRecIteratorAlt.h"
+
+using namespace std;
+
+// scans the table page by page; if readAhead is true, this asks for the next few pages
+// the same way that MyDB_TableRecIteratorAlt does.  Returns the number of records
+static size_t scan (MyDB_TableReaderWriter &scanMe, MyDB_RecordPtr temp, bool readAhead) {
+	size_t counter = 0;
+	for (int i = 0; i < scanMe.getNumPages (); i++) {
+		if (readAhead && i % (READ_AHEAD_PAGES / 2) == 0)
+			scanMe.getBufferMgr ()->prefetch (scanMe.getTable (), i + 1, READ_AHEAD_PAGES, true);
+		MyDB_RecordIteratorAltPtr myIter = scanMe.getForScan (i).getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counter++;
+		}
+	}
+	return counter;
+}
+
+// times a full scan of a big table with and without read-ahead, with the file dropped from
+// the OS cache first (cold) and with it cached (warm).  The runs without read-ahead go
+// first, since once the I/O thread has started, the process pays for atomic reference
+// counts on every shared_ptr.  Usage: readAheadBench [file.tbl]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	if (argc > 1)
+		fName = argv[1];
+
+	size_t pageSize = 65536;
+	MyDB_TablePtr myTable = loadSupplier ("supplier", "supplierBench.bin", fName, pageSize);
+
+	for (bool readAhead : {false, true}) {
+		for (bool cold : {true, false}) {
+			if (cold)
+				dropFromCache ("supplierBench.bin");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, 64, "benchTempFile");
+			MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+
+			BenchTimer timer;
+			size_t counter = scan (supplierTable, temp, readAhead);
+			cout << (cold ? "cold" : "warm") << (readAhead ? ", read-ahead:    " : ", no read-ahead: ")
+				<< counter << " records in " << timer.elapsed () << " seconds ("
+				<< myMgr->getNumMisses () << " synchronous reads)\n";
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,100 @@
+
+#ifndef REPLACEMENT_BENCH_C
+#define REPLACEMENT_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_ReplacementPolicy.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+// the shape of the "index" that is probed while the big table is being scanned: page 0 is
+// the root, the next few pages are inner nodes, and the rest are leaves
+#define NUM_INNER 7
+#define NUM_LEAVES 40
+
+// runs a point lookup into the index... this follows a root-to-leaf path the way a B+-Tree
+// probe would, touching each page on the way down
+static void probe (MyDB_TableReaderWriter &index, MyDB_RecordPtr temp) {
+	long inner = 1 + rand () % NUM_INNER;
+	long leaf = 1 + NUM_INNER + rand () % NUM_LEAVES;
+	for (long i : {0L, inner, leaf}) {
+		MyDB_RecordIteratorAltPtr myIter = index[i].getIteratorAlt ();
+		if (myIter->advance ())
+			myIter->getCurrent (temp);
+	}
+}
+
+// scans the big table once, probing the index every probeEvery records; reports the
+// hit ratio seen by the probes and by the whole workload
+static void runMix (MyDB_ReplacementType type, string name, bool tagScan, MyDB_TablePtr bigTable,
+	MyDB_TablePtr indexTable, size_t pageSize, size_t numFrames, int probeEvery) {
+
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile", type);
+	MyDB_TableReaderWriter big (bigTable, myMgr);
+	MyDB_TableReaderWriter index (indexTable, myMgr);
+	MyDB_RecordPtr bigRec = big.getEmptyRecord ();
+	MyDB_RecordPtr indexRec = index.getEmptyRecord ();
+
+	// warm up the index so that every policy starts from the same place
+	srand (12345);
+	for (int i = 0; i < 200; i++)
+		probe (index, indexRec);
+
+	size_t startHits = myMgr->getNumHits (), startMisses = myMgr->getNumMisses ();
+	size_t probeHits = 0, probeMisses = 0;
+
+	BenchTimer timer;
+	long counter = 0;
+	for (int i = 0; i < big.getNumPages (); i++) {
+		MyDB_PageReaderWriter page = tagScan ? big.getForScan (i) : big[i];
+		MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (bigRec);
+			if (++counter % probeEvery == 0) {
+				size_t hits = myMgr->getNumHits (), misses = myMgr->getNumMisses ();
+				probe (index, indexRec);
+				probeHits += myMgr->getNumHits () - hits;
+				probeMisses += myMgr->getNumMisses () - misses;
+			}
+		}
+	}
+	double time = timer.elapsed ();
+
+	size_t allHits = myMgr->getNumHits () - startHits;
+	size_t allMisses = myMgr->getNumMisses () - startMisses;
+	cout << name << (tagScan ? " (scan hint)   " : " (no hint)     ")
+		<< "probe misses: " << probeMisses << " of " << probeHits + probeMisses
+		<< " (hit ratio " << (double) probeHits / (probeHits + probeMisses) << ")   "
+		<< "overall hit ratio " << (double) allHits / (allHits + allMisses)
+		<< "   " << time << " seconds\n";
+}
+
+// measures the buffer hit ratio of each replacement policy on a mix of a big sequential scan
+// and random root-to-leaf probes into a small index, with and without the scan hint.
+// Usage: replacementBench [big.tbl] [numFrames]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t numFrames = 64;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		numFrames = atoi (argv[2]);
+
+	size_t pageSize = 16384;
+	MyDB_TablePtr bigTable = loadSupplier ("supplierBig", "supplierBigBench.bin", fName, pageSize);
+	MyDB_TablePtr indexTable = loadSupplier ("supplierIndex", "supplierIndexBench.bin", "supplier.tbl", pageSize);
+
+	cout << "scanning " << bigTable->lastPage () + 1 << " pages with " << numFrames << " frames, probing "
+		<< 1 + NUM_INNER + NUM_LEAVES << " index pages\n";
+	for (bool tagScan : {false, true}) {
+		runMix (MyDB_ReplacementType :: LRUReplacement, "LRU  ", tagScan, bigTable, indexTable, pageSize, numFrames, 200);
+		runMix (MyDB_ReplacementType :: ClockReplacement, "CLOCK", tagScan, bigTable, indexTable, pageSize, numFrames, 200);
+		runMix (MyDB_ReplacementType :: TwoQReplacement, "2Q   ", tagScan, bigTable, indexTable, pageSize, numFrames, 200);
+	}
+}
+
+#endif
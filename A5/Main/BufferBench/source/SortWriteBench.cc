@@ -0,0 +1,48 @@
+
+#ifndef SORT_WRITE_BENCH_C
+#define SORT_WRITE_BENCH_C
+
+#include "BenchUtils.h"
+#include "RecordComparator.h"
+#include "Sorting.h"
+
+using namespace std;
+
+// sorts the big supplier table on acctbal with a small buffer, once with the background
+// flusher turned off and once with it on, and reports how many page writes were made on the
+// eviction path, and how many writes of dead temp pages were skipped.
+// Usage: sortWriteBench [file.tbl] [numFrames]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplierBig.tbl";
+	size_t numFrames = 64;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		numFrames = atoi (argv[2]);
+
+	size_t pageSize = 32768;
+	MyDB_TablePtr myTable = loadSupplier ("supplier", "supplierBench.bin", fName, pageSize);
+
+	for (double cleanFraction : {0.0, 0.25, 0.5}) {
+
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile");
+		myMgr->setCleanFraction (cleanFraction);
+		MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("sorted", "sortedBench.bin", supplierSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+
+		BenchTimer timer;
+		sort (numFrames / 2, supplierTable, outputTable, myComp, rec1, rec2);
+		cout << "clean fraction " << cleanFraction << ": sorted " << supplierTable.getNumPages ()
+			<< " pages in " << timer.elapsed () << " seconds; " << myMgr->getNumEvictionWrites ()
+			<< " writes on eviction, " << myMgr->getNumBackgroundWrites () << " by the flusher, "
+			<< myMgr->getNumAvoidedWrites () << " temp page writes avoided\n";
+	}
+}
+
+#endif
@@ -0,0 +1,104 @@
+
+#ifndef STARTUP_BENCH_C
+#define STARTUP_BENCH_C
+
+#include "BenchUtils.h"
+#include <cstdlib>
+#include <cstring>
+#include "MyDB_FrameArena.h"
+#include <vector>
+
+using namespace std;
+
+// the number of random reads made by probe ()
+#define NUM_PROBES 20000000
+
+// touches every byte of every frame, the way that the first pass of a big sort would
+static void touch (vector <void *> &frames, size_t pageSize) {
+	for (void *frame : frames)
+		memset (frame, 1, pageSize);
+}
+
+// reads random words from random frames, which is about as hard on the TLB as it gets;
+// returns a checksum so that the loop is not optimized away
+static size_t probe (vector <void *> &frames, size_t pageSize) {
+	size_t sum = 0;
+	unsigned seed = 1;
+	for (size_t i = 0; i < NUM_PROBES; i++) {
+		seed = seed * 1103515245 + 12345;
+		char *frame = (char *) frames[seed % frames.size ()];
+		sum += frame[(seed >> 8) % pageSize];
+	}
+	return sum;
+}
+
+// compares the old way of getting buffer memory (one malloc per frame) against the single
+// mmap'd arena, on the time to get the memory, to first touch all of it, and to make a pile
+// of random reads from it; then times creating and destroying a buffer manager of that size.
+// The defaults are the page size, and the frame count that the SQL front end used to have.
+// Usage: startupBench [numFrames] [pageSize]
+int main (int argc, char *argv[]) {
+
+	size_t numFrames = 4028;
+	size_t pageSize = 131072;
+	if (argc > 1)
+		numFrames = atoi (argv[1]);
+	if (argc > 2)
+		pageSize = atoi (argv[2]);
+
+	size_t sink = 0;
+	BenchTimer timer;
+	{
+		vector <void *> frames;
+		timer.reset ();
+		for (size_t i = 0; i < numFrames; i++)
+			frames.push_back (malloc (pageSize));
+		double allocTime = timer.elapsed ();
+		timer.reset ();
+		touch (frames, pageSize);
+		double touchTime = timer.elapsed ();
+		timer.reset ();
+		sink += probe (frames, pageSize);
+		double probeTime = timer.elapsed ();
+		timer.reset ();
+		for (void *frame : frames)
+			free (frame);
+		double freeTime = timer.elapsed ();
+		cout << "malloc per frame: get " << allocTime << "s, first touch " << touchTime << "s, " << NUM_PROBES
+			<< " random reads " << probeTime << "s, give back " << freeTime << "s\n";
+	}
+
+	{
+		vector <void *> frames;
+		timer.reset ();
+		MyDB_FrameArenaPtr arena (new MyDB_FrameArena (pageSize, numFrames));
+		for (size_t i = 0; i < numFrames; i++)
+			frames.push_back (arena->getFrame (i));
+		double allocTime = timer.elapsed ();
+		timer.reset ();
+		touch (frames, pageSize);
+		double touchTime = timer.elapsed ();
+		timer.reset ();
+		sink += probe (frames, pageSize);
+		double probeTime = timer.elapsed ();
+		timer.reset ();
+		arena = nullptr;
+		double freeTime = timer.elapsed ();
+		cout << "frame arena:      get " << allocTime << "s, first touch " << touchTime << "s, " << NUM_PROBES
+			<< " random reads " << probeTime << "s, give back " << freeTime << "s\n";
+	}
+
+	// and the whole buffer manager, which now only has the one mmap to do
+	timer.reset ();
+	{
+		MyDB_BufferManager myMgr (pageSize, numFrames, "benchTempFile");
+		cout << "buffer manager:   created in " << timer.elapsed () << "s";
+		timer.reset ();
+	}
+	cout << ", destroyed in " << timer.elapsed () << "s\n";
+
+	// printing this keeps the loops from being optimized away
+	cout << "(checksum " << sink << ")\n";
+}
+
+#endif
@@ -0,0 +1,214 @@
+
+#ifndef TRACE_REPLAY_BENCH_C
+#define TRACE_REPLAY_BENCH_C
+
+#include "BenchUtils.h"
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_BufferTrace.h"
+#include "MyDB_ReplacementPolicy.h"
+#include "RecordComparator.h"
+#include "Sorting.h"
+#include <cstdlib>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// one entry in a page-reference stream: an access to the page with the given key, or (if
+// killed is true) the death of a temp page, which frees its frame
+struct Reference {
+	uint64_t key;
+	bool killed;
+};
+
+// reads the page-reference stream (the hits and misses, and the temp pages that went away)
+// out of a trace
+static vector <Reference> readStream (string fName) {
+	vector <Reference> stream;
+	MyDB_TraceReader reader (fName);
+	MyDB_TraceEvent event;
+	while (reader.next (event)) {
+		uint64_t key = (((uint64_t) event.slot) << 40) | event.pos;
+		if (event.type == (uint32_t) MyDB_TraceEventType :: Hit || event.type == (uint32_t) MyDB_TraceEventType :: Miss)
+			stream.push_back (Reference {key, false});
+		else if (event.type == (uint32_t) MyDB_TraceEventType :: KillTempPage)
+			stream.push_back (Reference {key, true});
+	}
+	return stream;
+}
+
+// replays the stream against one of the buffer manager's own replacement policies with
+// numFrames frames, and returns the number of hits... pins are not simulated, so this is
+// the hit rate that the policy would get if every page could be evicted
+static size_t replay (vector <Reference> &stream, MyDB_ReplacementType type, size_t numFrames) {
+	MyDB_ReplacementPolicyPtr policy = MyDB_ReplacementPolicy :: create (type, numFrames);
+	unordered_map <uint64_t, size_t> frameOf;
+	vector <uint64_t> pageIn (numFrames);
+	vector <size_t> freeFrames;
+	for (size_t i = numFrames; i > 0; i--)
+		freeFrames.push_back (i - 1);
+
+	size_t numHits = 0;
+	for (Reference &ref : stream) {
+		auto found = frameOf.find (ref.key);
+		if (ref.killed) {
+			if (found != frameOf.end ()) {
+				policy->remove (found->second);
+				freeFrames.push_back (found->second);
+				frameOf.erase (found);
+			}
+		} else if (found != frameOf.end ()) {
+			policy->touch (found->second);
+			numHits++;
+		} else {
+			size_t frame;
+			if (freeFrames.size () > 0) {
+				frame = freeFrames.back ();
+				freeFrames.pop_back ();
+			} else {
+				frame = policy->victim ();
+				frameOf.erase (pageIn[frame]);
+			}
+			pageIn[frame] = ref.key;
+			frameOf[ref.key] = frame;
+			policy->add (frame, ref.key);
+		}
+	}
+	return numHits;
+}
+
+// replays the stream against Belady's OPT, which always evicts the page that is next used
+// furthest in the future (a temp page that is killed is never used again); returns the
+// number of hits, which no policy can beat
+static size_t replayOPT (vector <Reference> &stream, size_t numFrames) {
+
+	// first, the next use of the page at each point in the stream
+	const size_t never = stream.size ();
+	vector <size_t> nextUse (stream.size ());
+	unordered_map <uint64_t, size_t> lastSeen;
+	for (size_t i = stream.size (); i > 0; i--) {
+		Reference &ref = stream[i - 1];
+		if (ref.killed) {
+			lastSeen[ref.key] = never;
+			continue;
+		}
+		auto found = lastSeen.find (ref.key);
+		nextUse[i - 1] = (found == lastSeen.end () ? never : found->second);
+		lastSeen[ref.key] = i - 1;
+	}
+
+	// the buffered pages, ordered by next use
+	set <pair <size_t, uint64_t>> buffered;
+	unordered_map <uint64_t, size_t> nextUseOf;
+	size_t numHits = 0;
+	for (size_t i = 0; i < stream.size (); i++) {
+		Reference &ref = stream[i];
+		auto found = nextUseOf.find (ref.key);
+		if (found != nextUseOf.end ()) {
+			buffered.erase (make_pair (found->second, ref.key));
+			nextUseOf.erase (found);
+			if (!ref.killed)
+				numHits++;
+		} else if (!ref.killed && buffered.size () == numFrames) {
+			auto victim = --buffered.end ();
+			nextUseOf.erase (victim->second);
+			buffered.erase (victim);
+		}
+		if (!ref.killed) {
+			buffered.insert (make_pair (nextUse[i], ref.key));
+			nextUseOf[ref.key] = nextUse[i];
+		}
+	}
+	return numHits;
+}
+
+// prints the hit rate of each policy at buffer sizes from a handful of frames up to enough
+// to hold every page that the job touched
+static void printCurve (string job, string traceFile) {
+	vector <Reference> stream = readStream (traceFile);
+	size_t numAccesses = 0;
+	set <uint64_t> distinct;
+	for (Reference &ref : stream) {
+		if (!ref.killed) {
+			numAccesses++;
+			distinct.insert (ref.key);
+		}
+	}
+
+	cout << "\n" << job << ": " << numAccesses << " page accesses to " << distinct.size () << " distinct pages\n";
+	cout << "  frames      LRU    CLOCK       2Q      OPT\n";
+	for (size_t numFrames = 4; ; numFrames *= 2) {
+		numFrames = min (numFrames, distinct.size ());
+		size_t hits[] = {replay (stream, MyDB_ReplacementType :: LRUReplacement, numFrames),
+			replay (stream, MyDB_ReplacementType :: ClockReplacement, numFrames),
+			replay (stream, MyDB_ReplacementType :: TwoQReplacement, numFrames),
+			replayOPT (stream, numFrames)};
+		printf ("  %6zu", numFrames);
+		for (size_t numHits : hits)
+			printf ("   %5.1f%%", numAccesses == 0 ? 0.0 : 100.0 * numHits / numAccesses);
+		printf ("\n");
+		fflush (stdout);
+		if (numFrames == distinct.size ())
+			break;
+	}
+}
+
+// records the page references made by three real jobs on the supplier table (loading it,
+// sorting it on acctbal, and building a B+-Tree on suppkey from it), each run with a buffer
+// of numFrames frames, and then replays each of them offline against LRU, CLOCK, 2Q and
+// OPT at a range of buffer sizes, to show how many frames each job really needs.
+// Usage: traceReplayBench [file.tbl] [numFrames]
+int main (int argc, char *argv[]) {
+
+	string fName = "supplier.tbl";
+	size_t numFrames = 64;
+	if (argc > 1)
+		fName = argv[1];
+	if (argc > 2)
+		numFrames = atoi (argv[2]);
+
+	size_t pageSize = 4096;
+	MyDB_TablePtr myTable = make_shared <MyDB_Table> ("supplier", "supplierReplay.bin", supplierSchema ());
+	{
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile");
+		myMgr->startTrace ("loadTrace.bin");
+		MyDB_TableReaderWriter loadMe (myTable, myMgr);
+		loadMe.loadFromTextFile (fName);
+		myMgr->stopTrace ();
+	}
+
+	{
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile");
+		MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("sorted", "sortedReplay.bin", supplierSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+		MyDB_RecordPtr rec1 = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = supplierTable.getEmptyRecord ();
+		function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+		myMgr->startTrace ("sortTrace.bin");
+		sort (numFrames / 2, supplierTable, outputTable, myComp, rec1, rec2);
+		myMgr->stopTrace ();
+	}
+
+	{
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numFrames, "benchTempFile");
+		MyDB_TablePtr treeTable = make_shared <MyDB_Table> ("supplierTree", "treeReplay.bin", supplierSchema ());
+		MyDB_BPlusTreeReaderWriter tree ("suppkey", treeTable, myMgr);
+
+		// (until MyDB_BPlusTreeReaderWriter :: append is written, this only touches the root)
+		myMgr->startTrace ("treeTrace.bin");
+		tree.loadFromTextFile (fName);
+		myMgr->stopTrace ();
+	}
+
+	cout << "recorded with " << numFrames << " frames of " << pageSize << " bytes; hit rates when replayed:\n";
+	printCurve ("load", "loadTrace.bin");
+	printCurve ("sort on acctbal", "sortTrace.bin");
+	printCurve ("B+-Tree build on suppkey", "treeTrace.bin");
+
+	for (string toGo : {"supplierReplay.bin", "sortedReplay.bin", "treeReplay.bin", "loadTrace.bin", "sortTrace.bin", "treeTrace.bin"})
+		unlink (toGo.c_str ());
+}
+
+#endif
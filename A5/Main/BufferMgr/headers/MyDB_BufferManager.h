@@ -13,30 +13,82 @@
 #ifndef BUFFER_MGR_H
 #define BUFFER_MGR_H
 
-#include "CheckLRU.h"
-#include <map>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include "MyDB_BufferStats.h"
+#include "MyDB_BufferTrace.h"
+#include "MyDB_FrameArena.h"
+#include "MyDB_FrameReservation.h"
+#include "MyDB_IOThread.h"
+#include "MyDB_LogManager.h"
 #include "MyDB_Page.h"
 #include "MyDB_PageHandle.h"
+#include "MyDB_ReplacementPolicy.h"
 #include "MyDB_Table.h"
-#include "PageCompare.h"
+#include "MyDB_TempSpace.h"
+#include "OpenHashTable.h"
 #include <queue>
-#include "TableCompare.h"
-#include <set>
+#include <vector>
+
+// the number of pages that a scan may still be working on... a scan page is only
+// demoted once this many newer scan pages have been read in
+#define NUM_CURRENT_SCAN_PAGES 2
+
+// the fraction of the buffer, at the cold end of the replacement policy, that the
+// background flusher tries to keep clean
+#define DEFAULT_CLEAN_FRACTION 0.25
+
+// the buffer is split into at most this many shards, as long as each one gets at least
+// MIN_FRAMES_PER_SHARD frames... so a small buffer is just one shard
+#define MAX_BUFFER_SHARDS 16
+#define MIN_FRAMES_PER_SHARD 64
+
+// once this many slots at the end of the temp file are free, the file is truncated; and
+// once this many slots have been freed, the free extents of at least this many slots get
+// their disk space punched out of the file
+#define TEMP_TRUNCATE_SLOTS 32
+#define TEMP_HOLE_SLOTS 32
+
+// how long (in milliseconds) an access or a pin waits for a frame to be unpinned, when every
+// frame in its shard is pinned, before it gives up
+#define FRAME_WAIT_MILLIS 1000
+
+// the most memory pools that a buffer manager can have, counting the default pool
+#define MAX_BUFFER_POOLS 8
+
+// without an explicit budget, the buffer gets this share of the memory that the process can use
+#define MEMORY_BUDGET_SHARE 4
 
 using namespace std;
 
 class MyDB_BufferManager;
 typedef shared_ptr <MyDB_BufferManager> MyDB_BufferManagerPtr;
 
+// the buffer manager may be used by many threads at once.  The page table and the frames
+// are split into shards, each with its own lock and its own replacement policy, and a page
+// always belongs to the same shard.  Note that with more than one thread, the bytes of an
+// unpinned page can be evicted at any time by another thread's request... so a thread that
+// shares the buffer manager should pin the pages that it is working on
 class MyDB_BufferManager {
 
 public:
 
 	// gets the i^th page in the table whichTable... note that if the page
 	// is currently being used (that is, the page is current buffered) a handle 
-	// to that already-buffered page should be returned
-	MyDB_PageHandle getPage (MyDB_TablePtr whichTable, long i);
+	// to that already-buffered page should be returned.  If sequentialScan is
+	// true, the page is being read as part of a scan and will probably not be
+	// needed again soon, so once the scan has moved on, the replacement policy
+	// gets rid of it early (unless somebody asks for it without the flag)
+	MyDB_PageHandle getPage (MyDB_TablePtr whichTable, long i, bool sequentialScan = false);
+
+	// starts reading pages [first, first + num) of whichTable in the background, so that
+	// a later getPage finds them already buffered.  Pages that are already buffered are
+	// skipped, and so are any that do not fit in the read-ahead budget (a quarter of the
+	// buffer), so this never blocks on I/O.  sequentialScan is as in getPage
+	void prefetch (MyDB_TablePtr whichTable, long first, long num, bool sequentialScan = false);
 
 	// gets a temporary page that will no longer exist (1) after the buffer manager
 	// has been destroyed, or (2) there are no more references to it anywhere in the
@@ -49,20 +101,51 @@ public:
 	// between this method and getPage (whicTable, i) is that the page will be 
 	// pinned in RAM; it cannot be written out to the file... note that in Chris'
 	// implementation, a request for a pinned page that is made when the buffer
-	// is ENTIRELY full of pinned pages will return a nullptr
+	// is ENTIRELY full of pinned pages will return a nullptr (once it has waited a
+	// while for somebody else to unpin a page; see setFrameWait)
 	MyDB_PageHandle getPinnedPage (MyDB_TablePtr whichTable, long i);
 
 	// gets a temporary page, like getPage (), except that this one is pinned
 	MyDB_PageHandle getPinnedPage ();
 
+	// reserves numPages contiguous slots in the temp file, so that a run of temporary pages
+	// (such as a sort run) can be laid out in order on disk; returns the first slot.  Each
+	// slot is used by calling getPage (slot), and is given back when that page goes away
+	size_t reserveTempPages (size_t numPages);
+
+	// gets a temporary page in a slot that was reserved by reserveTempPages
+	MyDB_PageHandle getPage (size_t reservedSlot);
+
+	// gives back reserved slots that were never used
+	void releaseTempPages (size_t firstSlot, size_t numPages);
+
+	// the size of the temp file, in pages, and the number of free slots in it
+	size_t getTempFileSize ();
+	size_t getNumFreeTempSlots ();
+
+	// pins the specified page, reading it in if need be; returns false if the page's
+	// shard is entirely full of pinned pages (and stays that way for the frame wait).
+	// Pins are counted, so the page stays pinned until it is unpinned as many times as it
+	// was pinned, or until there are no more handles to it
+	bool pin (const MyDB_PagePtr &pinMe);
+
 	// un-pins the specified page
-	void unpin (MyDB_PagePtr unpinMe);
+	void unpin (const MyDB_PagePtr &unpinMe);
 
-	// creates an LRU buffer manager... params are as follows:
+	// creates a buffer manager... params are as follows:
 	// 1) the size of each page is pageSize 
 	// 2) the number of pages managed by the buffer manager is numPages;
 	// 3) temporary pages are written to the file tempFile
-	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile);
+	// 4) evictions are chosen by the given replacement policy (LRU by default)
+	// 5) if directIO is true, files are opened with O_DIRECT, so that pages are not cached
+	//    a second time by the OS... this needs a page size that is a multiple of 4KB, and it
+	//    is quietly turned off otherwise, or for any file system that does not support it
+	// 6) the buffer may later be grown (by resize) to maxPages pages; zero means numPages.
+	//    Address space is set aside for maxPages frames, but memory is only used for the
+	//    frames that are in use
+	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile, 
+		MyDB_ReplacementType replacement = MyDB_ReplacementType :: LRUReplacement, bool directIO = false,
+		size_t maxPages = 0);
 	
 	// when the buffer manager is destroyed, all of the dirty pages need to be
 	// written back to disk, and any temporary files need to be deleted
@@ -70,54 +153,511 @@ public:
 
 	// returns the page size
 	size_t getPageSize ();
+
+	// the number of page accesses that found the page buffered, and that had to read it
+	size_t getNumHits ();
+	size_t getNumMisses ();
+
+	// the number of pages that had to be written when they were evicted, and the number
+	// that were written ahead of time by the background flusher
+	size_t getNumEvictionWrites ();
+	size_t getNumBackgroundWrites ();
+
+	// the number of dirty temporary pages that were evicted without being written (the flusher
+	// passes them over too), since nobody could read them again: they had been marked as
+	// discardable, or they had no handles left
+	size_t getNumAvoidedWrites ();
+
+	// a snapshot of all of the statistics, broken down by table... the counts are all since
+	// the buffer manager was created
+	MyDB_BufferStats getStats ();
+
+	// starts writing every buffer event (see MyDB_BufferTrace.h) to the given file, which
+	// can be replayed later; and stops.  Like setCleanFraction, these should be called while
+	// no other thread is using the buffer manager
+	void startTrace (string fName);
+	void stopTrace ();
+
+	// reserves between minFrames and maxFrames of the buffer's frames for an operator that is
+	// going to keep that many pages pinned or buffered at once (such as a sort, which sizes
+	// its runs from what it gets).  As many frames as are free are granted, up to maxFrames.
+	// If fewer than minFrames are free, this waits for other reservations to be given back
+	// if waitForFrames is true, and returns nullptr if it is not, or if minFrames is more
+	// than could ever be granted.  Reservations are only bookkeeping: a pin is not checked
+	// against them
+	MyDB_FrameReservationPtr reserveFrames (size_t minFrames, size_t maxFrames, bool waitForFrames = true);
+
+	// the number of frames that are reserved right now, and the most that can be (one frame
+	// in each shard is never reserved, so that unpinned pages can always be read)
+	size_t getNumReservedFrames ();
+	size_t getNumReservableFrames ();
+
+	// sets how long, in milliseconds, an access or a pin waits for another thread to unpin
+	// a page when every frame in the page's shard is pinned; zero means that it does not
+	// wait.  If there is still no frame after that, getPinnedPage returns nullptr, pin
+	// returns false, and getBytes returns nullptr
+	void setFrameWait (size_t millis);
+
+	// creates a named memory pool that gets at least minFrames and at most maxFrames of the
+	// buffer.  Every page belongs to a pool: the pages of a table to the pool that it was put
+	// in by setPool, and temp pages to the pool set by setTempPool; everything else is in
+	// the pool "default", which may have the whole buffer.  When a pool needs a frame, it
+	// evicts one of its own pages if it is at its maximum; otherwise, it takes one from the
+	// pool that has gone longest without an access, among those that have more than their
+	// minimum... so a pool that is busy cannot push another one below its minimum, and an
+	// idle pool's frames go to the pools that need them.  (A pool with nothing that it can
+	// evict, because its pages are pinned, may go over its maximum.)  Returns false if the
+	// name is taken, if there are already MAX_BUFFER_POOLS pools, or if the minimums would
+	// add up to more than can be reserved.  The pools (and setPool and setTempPool) should be
+	// set up before the buffer manager is shared between threads, and before the pages
+	// involved are used
+	bool createPool (string name, size_t minFrames, size_t maxFrames);
+
+	// puts the pages of the table, and the temp pages, in the named pool; returns false if
+	// there is no such pool
+	bool setPool (MyDB_TablePtr whichTable, string poolName);
+	bool setTempPool (string poolName);
+
+	// the number of frames that the pages in the named pool have right now
+	size_t getPoolSize (string poolName);
+
+	// sets the fraction of the frames, those next in line to be evicted, that the background
+	// flusher tries to keep clean; zero turns the flusher off.  This should be called before
+	// the buffer manager is shared between threads
+	void setCleanFraction (double fraction);
+
+	// the number of shards that the buffer is split into
+	size_t getNumShards ();
+
+	// the number of frames in the buffer right now, and the most that it can be grown to
+	size_t getNumPages ();
+	size_t getMaxPages ();
+
+	// grows or shrinks the buffer to numPages frames while it is in use, and returns the new
+	// size... which is numPages, held to at most getMaxPages (), and to at least one frame
+	// per shard, plus the frames that are reserved and the pools' minimums.  New frames can
+	// be used right away.  When the buffer shrinks, the pages in the frames that go away are
+	// evicted (and written back if they are dirty) and the memory is given back to the OS;
+	// a frame that holds a pinned page, or one that is being read, goes away once its page
+	// is unpinned or read and then evicted.  The pools keep their minimums and maximums
+	size_t resize (size_t numPages);
+
+	// the memory, in bytes, that the buffer should use on this machine: the environment
+	// variable MYDB_BUFFER_MEMORY if it is set (a number of bytes, which may end in K, M or G),
+	// and otherwise a 1 / MEMORY_BUDGET_SHARE share of the machine's memory, or of the cgroup
+	// memory limit that the process runs under if that is lower
+	static size_t getMemoryBudget ();
+
+	// resizes the buffer to fit the memory budget, which can change at run time if the
+	// process's cgroup limit does; returns the new number of frames
+	size_t resizeToBudget ();
+
+	// maps the whole pages that are in the table's file right now into memory, read-only...
+	// after this, the bytes of any of those pages are a pointer right into the mapping, so they
+	// are never copied and never take up a buffer frame.  Nothing may write to those pages.
+	// Pages that were already in existence are not affected.  Returns false (and leaves the
+	// table as it was) if the file is empty or cannot be mapped
+	bool mapReadOnly (MyDB_TablePtr whichTable);
+
+	// called when a scan over the table starts and finishes... while any scan is going on,
+	// the OS is told to read a mapped table sequentially (this does nothing for a table
+	// that is not mapped)
+	void startScan (MyDB_TablePtr whichTable);
+	void finishScan (MyDB_TablePtr whichTable);
+
+	// true if files are opened with O_DIRECT (a file system that refuses it still gets
+	// buffered I/O, one file at a time)
+	bool usesDirectIO ();
+
+	// turns page checksums on or off (they are off to start with).  When they are on, every
+	// page that is written gets a CRC32C of its contents in its header (see MyDB_Checksum.h),
+	// and every page that is read is checked against it; a page that does not match, because
+	// it was torn by a crash or damaged on disk, is a fatal error.  This needs pages that use
+	// the MyDB_PageReaderWriter layout, which leaves room for the checksum; pages of a table
+	// that is mapped with mapReadOnly are not checked.  It should be called before the buffer
+	// manager is shared between threads
+	void setPageChecksums (bool onOrOff);
+	bool usesPageChecksums ();
+
+	// sets the write-ahead log for the pages of tables: a page whose handle has been given an
+	// LSN (see MyDB_PageHandle :: setLSN) is not written to disk until the log is durable up
+	// to that LSN.  This should be called before the buffer manager is shared between threads,
+	// and before any tables are opened
+	void setLog (MyDB_LogManagerPtr log);
+	MyDB_LogManagerPtr getLog ();
+
+	// writes every dirty page of a table to disk, waits for any background writes, and then
+	// syncs the tables' files, so that everything that has been written to the tables is
+	// durable... this is a checkpoint for the log, so nothing should be writing pages while
+	// it is going on
+	void writeBackAll ();
 	
 private:
 
-	// tells us the LRU number of each of the pages
-	set <MyDB_PagePtr, CheckLRU> lastUsed;
+	// one partition of the buffer.  Everything in a shard, and everything in the pages
+	// that belong to it (other than the atomic counts), is protected by the shard's lock
+	struct Shard {
 
-	// list of ALL of the page objects that are currently in existence
-	map <pair <MyDB_TablePtr, size_t>, MyDB_PagePtr, PageCompare> allPages;
-	
-	// lists the FDs for all of the files
-	map <MyDB_TablePtr, int, TableCompare> fds;
+		mutex lock;
 
-	// all of the chunks of RAM that are currently not allocated
-	vector <void *> availableRam;
+		// signalled whenever a synchronous read into one of the shard's frames finishes, and
+		// (if anybody is waiting for one) whenever a frame is unpinned or freed
+		condition_variable loaded;
 
-	// all of the positions in the temporary file that are currently not in use
-	priority_queue<size_t, vector<size_t>, greater<size_t>> availablePositions;
+		// the table pages that belong to this shard and are currently in existence, keyed
+		// by pageKey (table slot, page number)
+		OpenHashTable <MyDB_PagePtr> pages;
 
-	// the page size
-	size_t pageSize;
+		// the shard owns frames [firstFrame, firstFrame + numFrames), of which the first
+		// numActive are in use... the rest are there for the buffer to grow into
+		size_t firstFrame;
+		size_t numFrames;
+		size_t numActive;
+
+		// decide which frame gets evicted, one for each pool... these work with frame numbers
+		// relative to firstFrame
+		vector <MyDB_ReplacementPolicyPtr> policies;
+
+		// an access count, and when each pool last had one of its pages accessed
+		uint64_t tick;
+		vector <uint64_t> lastUse;
+
+		// all of the shard's frames that are currently not allocated
+		vector <size_t> availableFrames;
+
+		// the number of pages that are being loaded with the shard unlocked
+		size_t numLoading;
+
+		// the number of threads that are waiting (on loaded) for a frame to be unpinned
+		size_t numFrameWaiters;
+
+		// the number of the shard's frames that hold pinned pages... this is only changed with the
+		// shard locked, but it is read without the lock to decide where to put pinned temp pages
+		atomic <size_t> numPinned;
+
+		// the frames (and page keys) most recently read in by scans... these pages are
+		// demoted once NUM_CURRENT_SCAN_PAGES newer scan pages have been read
+		deque <pair <size_t, uint64_t>> recentScanFrames;
+
+		// pages that have had a prefetch read started, in the order that they were started...
+		// a page stays here until its read is noticed to be done
+		deque <MyDB_PagePtr> pendingReads;
+
+		// the most pages that may be waiting on prefetch reads at one time
+		size_t maxPendingReads;
+
+		// the number of active frames, at the cold end of the policy, that the flusher keeps clean;
+		// the flusher is run once for every numToClean / 2 evictions
+		size_t numToClean;
+		size_t evictionsSinceClean;
 
-	// the time tick associated with the MRU page
-	long lastTimeTick;
+		// the frames that the flusher is looking at (kept around so as not to reallocate)
+		vector <size_t> coldFrames;
 
-	// the last position in the temporary file
-	size_t lastTempPos;
+		// the number of pages written on eviction, written by the flusher, and not written
+		// because they were dead (hits and misses are counted by table)
+		size_t numEvictionWrites;
+		size_t numBackgroundWrites;
+		size_t numAvoidedWrites;
+	};
+
+	// the shards... a page's shard is picked by shardFor (slot, pos), and remembered in the page
+	vector <unique_ptr <Shard>> shards;
+
+	// the RAM for all of the buffer frames
+	MyDB_FrameArenaPtr frameArena;
+
+	// the page that currently lives in each frame (nullptr if the frame is free)
+	vector <MyDB_PagePtr> frameOwners;
+
+	// protects files, slotTables, tableSlots and knownTables
+	mutex tableLock;
+
+	// what we know about each of the files that we have open
+	struct FileInfo {
+
+		int fd = -1;
+
+		// the read-only mapping of the file (nullptr if there is none), and the number of
+		// pages in it
+		char *mapping = nullptr;
+		size_t numMappedPages = 0;
+
+		// the number of scans going on over the mapping
+		size_t numScans = 0;
+
+		// the statistics for the file, and the pool that its pages go in
+		MyDB_TableCounters *counters = nullptr;
+		size_t pool = 0;
+	};
+
+	// a memory pool
+	struct Pool {
+		string name;
+		size_t minFrames;
+		size_t maxFrames;
+
+		// the frames held by the pool's pages right now
+		atomic <size_t> numFrames;
+	};
+
+	// all of the pools; pool 0 is the default pool
+	vector <unique_ptr <Pool>> pools;
+
+	// the pool that temp pages go in
+	atomic <size_t> tempPool;
+
+	// the replacement policy that each pool uses
+	MyDB_ReplacementType replacement;
+
+	// every table that we have seen gets a dense slot number; slot 0 is the
+	// temp file.  These are all of the files, indexed by slot
+	vector <FileInfo> files;
+
+	// the table that owns each slot (nullptr for the temp file)... two table
+	// objects with the same name share a slot, since they share a file
+	vector <MyDB_TablePtr> slotTables;
+
+	// maps the address of each table object we have seen to its slot
+	OpenHashTable <size_t> tableSlots;
+
+	// holds on to every table object in tableSlots, so that an address is never reused
+	vector <MyDB_TablePtr> knownTables;
+
+	// the statistics for each slot
+	vector <unique_ptr <MyDB_TableCounters>> tableCounters;
+
+	// the number of frames that are pinned, and the most that ever have been at once
+	atomic <size_t> numPinnedFrames;
+	atomic <size_t> maxPinnedFrames;
+
+	// the trace that events are written to, if tracing is on
+	MyDB_TraceWriterPtr trace;
+	atomic <bool> tracing;
+
+	// protects tempSpace and the temp file sizes
+	mutex tempLock;
+
+	// the slots in the temporary file that are currently in use
+	MyDB_TempSpace tempSpace;
+
+	// the number of slots that the temp file may have been written to since it was last
+	// truncated, the most that there ever have been, and the number that it has grown by
+	size_t tempFileSize;
+	size_t maxTempFileSize;
+	size_t tempFileGrowth;
+
+	// the page size
+	size_t pageSize;
 
 	// where we write the data
 	string tempFile;
 
-	// the number of buffer pages
-	size_t numPages;
+	// the number of buffer pages, and the most that there can be
+	atomic <size_t> numPages;
+	size_t maxPages;
+
+	// the fraction of each shard that the flusher keeps clean
+	double cleanFraction;
+
+	// true if files are opened with O_DIRECT
+	bool directIO;
+
+	// true if pages are checksummed
+	bool pageChecksums;
+
+	// the write-ahead log, if there is one
+	MyDB_LogManagerPtr log;
+
+	// services prefetch reads and background writes; this is created the first time that
+	// it is needed, by getIOThread ()
+	MyDB_IOThreadPtr ioThread;
+	once_flag ioThreadCreated;
+
+	// the frames that have been granted by reserveFrames; the lock protects the count (and
+	// is held while the buffer is resized), and the condition is signalled whenever frames
+	// are given back
+	mutex reservationLock;
+	condition_variable reservationsReleased;
+	size_t numReservedFrames;
 
-	// so that the page can access these private methods
+	// how long to wait for a frame to be unpinned
+	atomic <size_t> frameWaitMillis;
+
+	// so that the page (and a reservation) can access these private methods
 	friend class MyDB_Page;
+	friend class MyDB_FrameReservation;
 	friend class SortMergeJoin;
 
-	// kick out the LRU page
-	void kickOutPage ();
+	// the shard that page pos of the file in the given slot belongs to... consecutive pages
+	// of a file go to different shards, so that a scan is spread out over all of them
+	inline size_t shardFor (size_t slot, size_t pos) {
+		return (size_t) ((pos + slot * 0x9E3779B9ULL) & (shards.size () - 1));
+	}
 
-	// process an access to the given page
-	void access (MyDB_PagePtr updateMe);
+	// returns the I/O thread, starting it up if need be
+	MyDB_IOThreadPtr getIOThread ();
 
-	// removes all traces of the page from the buffer manager
-	void killPage (MyDB_PagePtr killMe);
+	// kick out the page chosen by chooseVictim, to make room for a page in the pool forPool...
+	// this may have to wait for reads into the shard to finish, in which case the shard is
+	// unlocked for a while.  Returns false if there was nothing to kick out
+	bool kickOutPage (Shard &shard, unique_lock <mutex> &guard, size_t forPool);
 
-};
+	// evicts the page, which has already been taken out of its replacement policy, writing
+	// it back if need be
+	void evictPage (Shard &shard, MyDB_PagePtr page);
 
-#endif
+	// true if the frame is not in use any more, because the buffer has shrunk
+	inline bool isRetired (Shard &shard, size_t whichFrame) {
+		return whichFrame - shard.firstFrame >= shard.numActive;
+	}
+
+	// puts a frame that no page has back on the shard's list of available frames... or, if
+	// the frame is retired, gives its memory back
+	void freeFrame (Shard &shard, size_t whichFrame);
+
+	// called when a page has been unpinned, to evict it if it is in a retired frame
+	void checkRetired (Shard &shard, MyDB_PagePtr page);
+
+	// sets everything about the shard that depends on its number of active frames
+	void setNumActive (Shard &shard, size_t numActive);
+
+	// takes an evictable frame away from the pool chosen (as described at createPool) to give
+	// a frame to the pool forPool; returns -1 if no pool has one to give
+	long chooseVictim (Shard &shard, size_t forPool);
+
+	// fills shard.coldFrames with up to num evictable frames, coldest first, from every pool
+	void findColdFrames (Shard &shard, size_t num);
+
+	// the replacement policy that decides about the page
+	inline MyDB_ReplacementPolicyPtr &policyFor (Shard &shard, MyDB_Page &page) {
+		return shard.policies[page.pool];
+	}
+
+	// the pool with the given name; -1 if there is none
+	long findPool (string name);
+
+	// gets a free frame from the shard for a page in the pool forPool, kicking out a page if
+	// necessary (or if the pool is at its maximum); returns -1 if there is none.  This may
+	// unlock the shard for a while
+	long getFrame (Shard &shard, unique_lock <mutex> &guard, size_t forPool);
+
+	// like getFrame, except that if every frame in the shard is pinned, this waits up to
+	// frameWaitMillis for one of them to be unpinned
+	long waitForFrame (Shard &shard, unique_lock <mutex> &guard, size_t forPool);
+
+	// called with the shard locked when a frame may have become free or evictable, to wake
+	// up anybody who is waiting for one
+	inline void frameFreed (Shard &shard) {
+		if (shard.numFrameWaiters > 0)
+			shard.loaded.notify_all ();
+	}
+
+	// gives back frames that were reserved
+	void releaseFrames (size_t numFrames);
+
+	// gives the frame whichFrame to the page putHere
+	void assignFrame (MyDB_PagePtr putHere, size_t whichFrame);
+
+	// takes the frame away from the page takeMe, and makes it available
+	void releaseFrame (Shard &shard, MyDB_PagePtr takeMe);
+
+	// process an access to the given page; returns false if there was no frame to read
+	// it into
+	bool access (const MyDB_PagePtr &updateMe);
+
+	// makes sure that the page is buffered, reading it if need be, and either tells the
+	// replacement policy about the access or (if pinIt is true) pins it.  The read is done
+	// with the shard unlocked.  Returns false if no frame could be found
+	bool bringIn (Shard &shard, unique_lock <mutex> &guard, MyDB_PagePtr bringMe, bool pinIt);
+
+	// the page can be evicted again (it was just read, or just unpinned)
+	void makeEvictable (Shard &shard, MyDB_PagePtr page);
 
+	// waits for the prefetch read into the given page to finish, and makes the page evictable
+	void finishRead (Shard &shard, MyDB_PagePtr readMe);
 
+	// finishes off all of the shard's prefetch reads that are done, oldest first; if waitForAll
+	// is true, this blocks until every outstanding read is done
+	void reapReads (Shard &shard, bool waitForAll);
+
+	// reads the page's bytes from its file; any error is fatal
+	void readPage (MyDB_PagePtr readMe);
+
+	// checks the checksum of a page that was just read, if pages are checksummed; a page
+	// that does not match is fatal
+	void checkPage (MyDB_PagePtr readMe);
+
+	// makes sure that none of the I/O done by ioThread has failed; any error is fatal
+	void checkBackgroundIO ();
+
+	// the name of the file in the given slot, for error messages
+	string getFileName (size_t slot);
+
+	// opens the file with the given flags; any error is fatal
+	int openFile (string fName, int flags);
+
+	// waits for the background write of the page, if there is one
+	void finishWrite (MyDB_PagePtr writeMe);
+
+	// writes the given dirty pages, sorted by file and position, with adjacent pages
+	// merged into one pwritev... if inBackground is true, the writes go to the I/O thread
+	void writeBack (vector <MyDB_PagePtr> &writeMe, bool inBackground);
+
+	// has the I/O thread write out the dirty pages among the shard's next numToClean victims
+	void cleanColdFrames (Shard &shard);
+
+	// called when a scan first gets to a page that it read; demotes the scan page that
+	// is NUM_CURRENT_SCAN_PAGES pages behind it
+	void scannedPage (Shard &shard, MyDB_PagePtr scanMe);
+
+	// drops what was the last handle to the page (unless another one has been made since),
+	// and kills the page if there are no more
+	void killPage (MyDB_Page *killMe);
+
+	// removes all traces of the page from the buffer manager... the shard must be locked
+	void killPage (Shard &shard, MyDB_PagePtr killMe);
+
+	// true if the page is a temporary page whose bytes will never be read again, so that
+	// it need not be written when it leaves the buffer
+	bool isDead (MyDB_PagePtr page);
+
+	// opens the temp file if it is not open yet, and returns what we know about it
+	FileInfo getTempFile ();
+
+	// called with tempLock held after slots may have been added to the temp file
+	void checkTempGrowth ();
+
+	// called whenever a frame is pinned, and unpinned, to keep the pinned counts
+	void pinnedFrame (Shard &shard);
+	void unpinnedFrame (Shard &shard);
+
+	// writes an event to the trace, if tracing is on
+	inline void traceEvent (MyDB_TraceEventType type, MyDB_Page &page) {
+		if (tracing)
+			trace->record (type, page.slot, page.pos);
+	}
+
+	// makes a temporary page in the given slot of the temp file
+	MyDB_PageHandle makeTempPage (size_t slot);
+
+	// gives slots of the temp file back, shrinking the file or punching holes in it if
+	// enough of it is free
+	void releaseTempSlots (size_t firstSlot, size_t numSlots);
+
+	// gets the slot for the given table, opening its file if it has never been seen,
+	// and copies the file's information into file
+	size_t getSlot (MyDB_TablePtr forMe, FileInfo &file);
+
+	// creates page i of the table in the given slot, and puts it in its shard's page table...
+	// the shard must be locked
+	MyDB_PagePtr makePage (MyDB_TablePtr whichTable, long i, size_t slot, FileInfo &file);
+
+	// the key used to find a page in a shard's page table
+	static inline uint64_t pageKey (size_t slot, size_t pos) {
+		return (((uint64_t) slot) << 40) | (uint64_t) pos;
+	}
+
+};
+
+#endif
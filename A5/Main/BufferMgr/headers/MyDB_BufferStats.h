@@ -0,0 +1,120 @@
+
+#ifndef BUFFER_STATS_H
+#define BUFFER_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace std;
+
+// I/O latencies are kept as histograms with power-of-two buckets: bucket 0 counts the
+// transfers that took less than 2 microseconds, bucket i those that took [2^i, 2^(i+1))
+// microseconds, and the last bucket everything slower than that
+#define NUM_LATENCY_BUCKETS 24
+
+// what happened to the pages of one table (or to the temp pages) over some stretch of time
+struct MyDB_TableStats {
+
+	// accesses that found the page buffered, and that had to read it
+	size_t numHits = 0;
+	size_t numMisses = 0;
+
+	// pages read ahead of time, pages evicted, and pages written back to disk (by eviction,
+	// by the background flusher, or at shutdown)
+	size_t numPrefetches = 0;
+	size_t numEvictions = 0;
+	size_t numWriteBacks = 0;
+
+	// the bytes moved, and how long each read or write call took
+	size_t bytesRead = 0;
+	size_t bytesWritten = 0;
+	size_t readLatency[NUM_LATENCY_BUCKETS] = {};
+	size_t writeLatency[NUM_LATENCY_BUCKETS] = {};
+
+	// adds the counts in addMe to these
+	void add (const MyDB_TableStats &addMe);
+
+	// the fraction of the accesses that were hits
+	double hitRate () const;
+
+	// an upper bound on the given percentile (say, 0.99) of the read or write latency, in
+	// microseconds; 0 if there were none
+	size_t readPercentile (double p) const;
+	size_t writePercentile (double p) const;
+
+	// the bucket that a latency of the given number of microseconds goes in
+	static size_t bucketFor (double micros);
+};
+
+// the size of one memory pool, and its limits, in frames
+struct MyDB_PoolStats {
+	size_t numFrames = 0;
+	size_t minFrames = 0;
+	size_t maxFrames = 0;
+};
+
+// a snapshot of the buffer manager's statistics
+struct MyDB_BufferStats {
+
+	// everything together, and broken down by table name (temp pages are under "<temp>")
+	MyDB_TableStats total;
+	map <string, MyDB_TableStats> byTable;
+
+	// the memory pools, by name
+	map <string, MyDB_PoolStats> byPool;
+
+	// the number of frames in the buffer, the number that are pinned right now, and the
+	// most that have ever been pinned at once
+	size_t numFrames = 0;
+	size_t numPinned = 0;
+	size_t maxPinned = 0;
+
+	// the size of the temp file, in pages, now and at its largest, and the number of pages
+	// that it has grown by in all
+	size_t tempFileSize = 0;
+	size_t maxTempFileSize = 0;
+	size_t tempFileGrowth = 0;
+
+	// writes made on eviction and by the background flusher, and writes of dead temp pages
+	// that were skipped
+	size_t numEvictionWrites = 0;
+	size_t numBackgroundWrites = 0;
+	size_t numAvoidedWrites = 0;
+
+	// writes out a human-readable report
+	void print (ostream &toMe) const;
+};
+
+// the live counters for one table, which are updated by many threads without any lock
+class MyDB_TableCounters {
+
+public:
+
+	// everything starts at zero
+	MyDB_TableCounters ();
+
+	// counts a read or write of numBytes that took the given number of microseconds
+	void countRead (size_t numBytes, double micros);
+	void countWrite (size_t numBytes, double micros);
+
+	// copies the counts into intoMe
+	void snapshot (MyDB_TableStats &intoMe);
+
+	atomic <size_t> numHits;
+	atomic <size_t> numMisses;
+	atomic <size_t> numPrefetches;
+	atomic <size_t> numEvictions;
+	atomic <size_t> numWriteBacks;
+
+private:
+
+	atomic <size_t> bytesRead;
+	atomic <size_t> bytesWritten;
+	atomic <size_t> readLatency[NUM_LATENCY_BUCKETS];
+	atomic <size_t> writeLatency[NUM_LATENCY_BUCKETS];
+};
+
+#endif
@@ -0,0 +1,105 @@
+
+#ifndef BUFFER_TRACE_H
+#define BUFFER_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// a trace file starts with these eight bytes, and then the page size (as a uint64_t)... after
+// that, it is just a list of MyDB_TraceEvents.  A SlotName event is followed right away by
+// the pos bytes of the name of the table with that slot, so that a trace can be read without
+// the catalog; slot 0 is always the temp file
+#define TRACE_MAGIC "MYDBTRC1"
+
+// the number of events that are kept in RAM before they are written to the trace file
+#define TRACE_BUFFER_EVENTS 4096
+
+// the things that are traced
+enum class MyDB_TraceEventType : uint32_t {
+	Hit,		// an access to a buffered page
+	Miss,		// an access that had to read the page
+	Prefetch,	// a page read ahead of time
+	Pin,		// a page pinned (pins of pinned pages are counted, too)
+	Unpin,		// a pin undone (or all of them, when the last handle to a pinned page goes)
+	Evict,		// a page evicted from the buffer
+	WriteBack,	// a page written to disk
+	NewTempPage,	// a temp page created (pos is its slot in the temp file)
+	KillTempPage,	// the last handle to a temp page gone
+	SlotName	// a table given a slot number
+};
+
+// one event... time is in nanoseconds from the start of the trace
+struct MyDB_TraceEvent {
+	uint64_t time;
+	uint32_t type;
+	uint32_t slot;
+	uint64_t pos;
+};
+
+class MyDB_TraceWriter;
+typedef unique_ptr <MyDB_TraceWriter> MyDB_TraceWriterPtr;
+
+// writes a trace of the buffer manager's events; it is safe to call record from many threads
+class MyDB_TraceWriter {
+
+public:
+
+	// creates the trace file; any error is fatal
+	MyDB_TraceWriter (string fName, size_t pageSize);
+
+	// writes out whatever is left, and closes the file
+	~MyDB_TraceWriter ();
+
+	// records one event
+	void record (MyDB_TraceEventType type, size_t slot, size_t pos);
+
+	// records the name of the table in the given slot
+	void nameSlot (size_t slot, string name);
+
+private:
+
+	// writes out the events in RAM; the lock must be held
+	void flush ();
+
+	mutex lock;
+	FILE *file;
+	vector <MyDB_TraceEvent> events;
+	chrono :: steady_clock :: time_point start;
+};
+
+// reads a trace file back
+class MyDB_TraceReader {
+
+public:
+
+	// opens the trace file; any error (including a file that is not a trace) is fatal
+	MyDB_TraceReader (string fName);
+
+	~MyDB_TraceReader ();
+
+	// gets the next event (SlotName events are not returned; they just set the slot names);
+	// returns false at the end of the trace
+	bool next (MyDB_TraceEvent &intoMe);
+
+	// the page size of the buffer manager that was traced
+	size_t getPageSize ();
+
+	// the name of the table in the given slot, as far as the trace has been read
+	string getSlotName (size_t slot);
+
+private:
+
+	FILE *file;
+	size_t pageSize;
+	map <size_t, string> slotNames;
+};
+
+#endif
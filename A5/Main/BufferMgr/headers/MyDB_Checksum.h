@@ -0,0 +1,40 @@
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// where a page's checksum lives: four bytes that the page header leaves free (the page type
+// takes up the first four bytes of the header's first word, and the number of bytes used
+// is in the second word; see MyDB_PageReaderWriter.cc)
+#define PAGE_CHECKSUM_OFFSET 4
+
+// the CRC32C (Castagnoli) of numBytes bytes, continuing on from crc (which is zero to start
+// a new one)... this uses the SSE 4.2 or ARMv8 CRC instructions if the machine has them,
+// running three streams at once to hide the latency of the instruction
+uint32_t crc32c (uint32_t crc, const void *data, size_t numBytes);
+
+// the same, always computed a table at a time in software
+uint32_t crc32cSoftware (uint32_t crc, const void *data, size_t numBytes);
+
+// true if crc32c uses hardware instructions on this machine
+bool hasHardwareCRC32C ();
+
+// the checksum of a page of pageSize bytes: the CRC32C of everything but the checksum itself
+uint32_t pageChecksum (const void *page, size_t pageSize);
+
+// the checksum that is stored in the page
+uint32_t storedChecksum (const void *page);
+
+// computes the page's checksum and stores it in the page
+void setPageChecksum (void *page, size_t pageSize);
+
+// true if the checksum stored in the page matches its contents... a page with a stored
+// checksum of zero was written without one (or was never written at all, and so is all
+// zeros), and always passes
+bool pageChecksumOK (const void *page, size_t pageSize);
+
+#endif
@@ -0,0 +1,42 @@
+
+#ifndef CLOCK_POLICY_H
+#define CLOCK_POLICY_H
+
+#include "MyDB_ReplacementPolicy.h"
+#include <vector>
+
+using namespace std;
+
+// CLOCK (second chance) replacement... a hand sweeps over the fixed array of frames;
+// a frame whose reference bit is set gets the bit cleared and is passed over, and the
+// first evictable frame with a clear bit is the victim.  An access just sets a bit, and
+// demoting a frame clears it
+class MyDB_ClockPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_ClockPolicy (size_t numFrames);
+
+	void add (size_t whichFrame, uint64_t whichPage) override;
+	void touch (size_t whichFrame) override;
+	void demote (size_t whichFrame) override;
+	void remove (size_t whichFrame) override;
+	long victim () override;
+	void coldest (size_t num, vector <size_t> &coldFrames) override;
+
+private:
+
+	// whether each frame holds an evictable page
+	vector <char> evictable;
+
+	// the reference bit for each frame
+	vector <char> referenced;
+
+	// where the hand points
+	size_t hand;
+
+	// how many frames are evictable
+	size_t numEvictable;
+};
+
+#endif
@@ -0,0 +1,33 @@
+
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include <string>
+#include <sys/uio.h>
+
+using namespace std;
+
+// positional page I/O used by the buffer manager.  These never move the file offset, so
+// the same fd can be used by more than one thread at once, and they keep going after a
+// short read or write (or an EINTR) until all of the bytes have been moved.  If the fd was
+// opened with O_DIRECT and a transfer is refused with EINVAL, the fd is quietly switched over
+// to buffered I/O and the transfer is retried.  Each returns false if there was an I/O error,
+// with errno set
+
+// reads into the numPieces given pieces of memory, one after another, starting at offset
+// in fd... any part of the pieces that is past the end of the file is filled with zeros
+bool readFully (int fd, const iovec *pieces, int numPieces, size_t offset);
+
+// same as above, for one piece of memory
+bool readFully (int fd, void *intoMe, size_t numBytes, size_t offset);
+
+// writes the numPieces given pieces of memory, one after another, starting at offset in fd
+bool writeFully (int fd, const iovec *pieces, int numPieces, size_t offset);
+
+// same as above, for one piece of memory
+bool writeFully (int fd, void *fromMe, size_t numBytes, size_t offset);
+
+// describes the last error (from errno) for an error message
+string lastIOError ();
+
+#endif
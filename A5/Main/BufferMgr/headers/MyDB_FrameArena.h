@@ -0,0 +1,68 @@
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+
+// frames whose size is a multiple of this are aligned to it, so that they can be used for
+// O_DIRECT I/O... smaller frames are only aligned to a cache line
+#define FRAME_ALIGNMENT 4096
+#define CACHE_LINE_SIZE 64
+
+// the size of a huge page; an arena at least this big is aligned to it and backed by huge
+// pages if the OS will give them to us
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+using namespace std;
+
+class MyDB_FrameArena;
+typedef unique_ptr <MyDB_FrameArena> MyDB_FrameArenaPtr;
+
+// one block of memory that all of the buffer frames are carved out of, instead of one malloc
+// per frame.  The memory comes from a single mmap, so it is zeroed, it is not touched until a
+// frame is first used, and (when it is big enough) it is backed by 2MB pages, which cuts down
+// on TLB misses when a scan or a sort sweeps through the buffer.  Explicitly reserved huge
+// pages (MAP_HUGETLB) are used if there are any; otherwise we ask for transparent huge pages
+class MyDB_FrameArena {
+
+public:
+
+	// gets the memory for numFrames frames of frameSize bytes each; any error is fatal.  The
+	// memory is only reserved, so frames that are never used cost nothing
+	MyDB_FrameArena (size_t frameSize, size_t numFrames);
+
+	// gives the memory back
+	~MyDB_FrameArena ();
+
+	// returns the i^th frame
+	inline void *getFrame (size_t i) {
+		return base + i * stride;
+	}
+
+	// gives the memory behind frames [first, first + num) back to the OS, for a buffer that
+	// has shrunk... the frames can still be used, and are zeroed when they next are
+	void discard (size_t first, size_t num);
+
+	// the distance between the starts of consecutive frames
+	size_t getStride ();
+
+	// true if every frame is FRAME_ALIGNMENT aligned
+	bool isPageAligned ();
+
+	// true if the arena is backed by reserved huge pages; false if it is backed by regular
+	// pages (which the OS may still merge into transparent huge pages)
+	bool usesReservedHugePages ();
+
+private:
+
+	// the start of the frames, and the start and size of the mapping that holds them
+	char *base;
+	void *mapping;
+	size_t mappingSize;
+
+	size_t stride;
+	bool reservedHugePages;
+};
+
+#endif
@@ -0,0 +1,38 @@
+
+#ifndef FRAME_RESERVATION_H
+#define FRAME_RESERVATION_H
+
+#include <cstddef>
+#include <memory>
+
+using namespace std;
+
+class MyDB_BufferManager;
+class MyDB_FrameReservation;
+typedef shared_ptr <MyDB_FrameReservation> MyDB_FrameReservationPtr;
+
+// some number of the buffer's frames, granted to one operator by
+// MyDB_BufferManager :: reserveFrames.  The operator promises not to keep more pages than
+// that pinned (or buffered, and needed) at once; in return, the other operators are not
+// granted frames that it may need.  The frames are given back when this is destroyed
+class MyDB_FrameReservation {
+
+public:
+
+	// the number of frames that were granted
+	size_t getNumFrames ();
+
+	// gives the frames back
+	~MyDB_FrameReservation ();
+
+private:
+
+	// only the buffer manager makes reservations
+	friend class MyDB_BufferManager;
+	MyDB_FrameReservation (MyDB_BufferManager &parent, size_t numFrames);
+
+	MyDB_BufferManager &parent;
+	size_t numFrames;
+};
+
+#endif
@@ -0,0 +1,110 @@
+
+#ifndef IO_THREAD_H
+#define IO_THREAD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "MyDB_BufferStats.h"
+#include <string>
+#include <sys/uio.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class MyDB_IOThread;
+typedef shared_ptr <MyDB_IOThread> MyDB_IOThreadPtr;
+
+// a background thread that services page reads and writes for the buffer manager, so that
+// the I/O can be started now and waited for later.  Requests are serviced in the order that they
+// are submitted, and each one gets a ticket number... so a request is done as soon as
+// the number of completed requests is larger than its ticket.  The buffer manager owns all
+// of the memory that is read into or written from; it must not touch memory that is being
+// read into, or reuse memory that is being written from, until the request is done
+class MyDB_IOThread {
+
+public:
+
+	// starts up the thread
+	MyDB_IOThread ();
+
+	// finishes all of the outstanding requests, then shuts the thread down
+	~MyDB_IOThread ();
+
+	// queues up a read of numBytes bytes at offset in the file fd into intoMe; returns
+	// the ticket for the request.  If countIn is not null, the bytes read and the time
+	// that the read took are counted in it
+	size_t read (int fd, size_t offset, void *intoMe, size_t numBytes, MyDB_TableCounters *countIn = nullptr);
+
+	// queues up a write of the given pieces of memory, one after another, at offset in
+	// the file fd (with a single pwritev); returns the ticket for the request.  countIn
+	// is as above.  If freeMe is not null, it is memory from malloc (usually a copy that
+	// the pieces point into) that is handed over to the thread, and freed once the write is done
+	size_t write (int fd, size_t offset, vector <iovec> pieces, MyDB_TableCounters *countIn = nullptr,
+		void *freeMe = nullptr);
+
+	// returns true if the request with the given ticket has been serviced
+	inline bool isDone (size_t ticket) {
+		return numCompleted.load (memory_order_acquire) > ticket;
+	}
+
+	// blocks until the request with the given ticket has been serviced
+	void wait (size_t ticket);
+
+	// blocks until every request submitted so far has been serviced
+	void drain ();
+
+	// returns true if any request has failed... the request still counts as serviced
+	inline bool failed () {
+		return hasFailed.load (memory_order_acquire);
+	}
+
+	// describes the first request that failed
+	string getError ();
+
+private:
+
+	// a queued-up read or write
+	struct Request {
+		bool isWrite;
+		int fd;
+		size_t offset;
+		vector <iovec> pieces;
+		MyDB_TableCounters *countIn;
+		void *freeMe;
+	};
+
+	// queues up the request and returns its ticket
+	size_t submit (Request doMe);
+
+	// the loop run by the thread
+	void run ();
+
+	// protects everything but numCompleted
+	mutex lock;
+
+	// signalled when a request is submitted, and when one is finished
+	condition_variable workToDo;
+	condition_variable workDone;
+
+	// the requests that have not been serviced
+	deque <Request> requests;
+
+	// the number of requests submitted, and the number serviced
+	size_t numSubmitted;
+	atomic <size_t> numCompleted;
+
+	// set when the destructor is called
+	bool shuttingDown;
+
+	// set when a request fails, along with a description of the first failure
+	atomic <bool> hasFailed;
+	string error;
+
+	thread worker;
+};
+
+#endif
@@ -0,0 +1,48 @@
+
+#ifndef LRU_POLICY_H
+#define LRU_POLICY_H
+
+#include "MyDB_ReplacementPolicy.h"
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// classic LRU, using a time tick per frame and an ordered set of (tick, frame) pairs...
+// demoted frames get ticks from a separate counter that is always older than the main
+// one, so that they are evicted first (in FIFO order) unless somebody reuses them
+class MyDB_LRUPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_LRUPolicy (size_t numFrames);
+
+	void add (size_t whichFrame, uint64_t whichPage) override;
+	void touch (size_t whichFrame) override;
+	void demote (size_t whichFrame) override;
+	void remove (size_t whichFrame) override;
+	long victim () override;
+	void coldest (size_t num, vector <size_t> &coldFrames) override;
+	void setNumFrames (size_t numFrames) override;
+
+private:
+
+	// all of the evictable frames, ordered so that the LRU one is first
+	set <pair <long, size_t>> lastUsed;
+
+	// the time tick of the last access to each frame; -1 if it is not in lastUsed
+	vector <long> timeTicks;
+
+	// the time tick associated with the MRU frame
+	long lastTimeTick;
+
+	// the time tick associated with the most recently demoted frame
+	long lastDemotedTick;
+
+	// the number of frames that are in use... timeTicks also covers the frames that the
+	// buffer has room to grow into
+	size_t numActive;
+};
+
+#endif
@@ -0,0 +1,201 @@
+
+#ifndef LOG_MANAGER_H
+#define LOG_MANAGER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "MyDB_Catalog.h"
+#include "MyDB_Table.h"
+
+using namespace std;
+
+// the write-ahead log is a list of records, each of which is a LogRecordHeader and then the
+// record's payload.  The checksum is the CRC32C of the type and the payload, so that a record
+// that was torn by a crash (which can only be the last one) is taken as the end of the log.
+// The first record is always a Start record, with the page size in it
+struct LogRecordHeader {
+	uint32_t length;	// the length of the record, header included
+	uint32_t checksum;
+	uint32_t type;
+};
+
+// the kinds of records
+enum class MyDB_LogRecordType : uint32_t {
+	Start,		// the page size (uint64_t)
+	Table,		// a table id (uint32_t) for the records below, then the table's name and file
+	PageImage,	// table id, page number (uint64_t), and then all of the bytes of the page
+	PageClear,	// table id and page number: the page is all zeros
+	PageWrite,	// table id, page number, offset (uint32_t), the number of header bytes (uint32_t),
+			// the bytes written at the offset, and then the bytes at the start of the page
+	Catalog		// a catalog key and its value
+};
+
+// the number of bytes of records that are kept in RAM before they are written out
+#define DEFAULT_LOG_BUFFER (4 * 1024 * 1024)
+
+class MyDB_BufferManager;
+class MyDB_LogManager;
+typedef shared_ptr <MyDB_LogManager> MyDB_LogManagerPtr;
+
+// a redo-only write-ahead log for the pages of tables and for the catalog.  A change to a
+// page is logged as the bytes that it wrote (the first change to a page after a checkpoint
+// logs the whole page, unless the change empties the page out, so that a page that was torn
+// by a crash is rebuilt from scratch); the page handle is then told the LSN of the record,
+// and the buffer manager makes sure that the log is durable up to that LSN before the page
+// goes to disk.  Records are kept in RAM until they are committed, or until a page needs
+// them, or the RAM fills up; then a thread of the log's own writes them out with a single
+// write and fdatasync, while records keep being logged into a second buffer.  Commits that
+// come in while a write is going on share the next one (group commit).  After a crash,
+// recover puts the tables and catalog back the way that they were at the last thing that
+// was made durable.  LSNs are byte positions in the log, and they keep growing across
+// checkpoints.  Logging and commits are safe from any number of threads; recover and
+// checkpoint must run with nothing else going on
+class MyDB_LogManager {
+
+public:
+
+	// opens the log file, creating it if need be, for a buffer manager with the given page size;
+	// bufferSize bytes of records are kept in RAM before they have to be written.  The log is
+	// not replayed here: call recover before anything is logged, or else the log is cleared out
+	MyDB_LogManager (string fName, size_t pageSize, size_t bufferSize = DEFAULT_LOG_BUFFER);
+
+	// makes the log durable and closes it
+	~MyDB_LogManager ();
+
+	// logs that numBytes bytes at offset in page whichPage of the table were written, along
+	// with the first headerBytes bytes of the page (for a header that counts what is on the
+	// page, say); pageBytes is the page, which already has the write in it.  A write that
+	// starts where the last one logged for the same page ended goes into the same record, as
+	// long as that record has not been handed to the writer, so a run of appends to a page is
+	// logged once, with the header once.  Returns the LSN of the end of the record
+	size_t logWrite (MyDB_TablePtr whichTable, size_t whichPage, void *pageBytes, size_t offset, size_t numBytes,
+		size_t headerBytes = 0);
+
+	// logs that the page was emptied out (it is redone as a page of zeros, so whatever is then
+	// written to it has to be logged as well); returns the LSN of the record
+	size_t logClear (MyDB_TablePtr whichTable, size_t whichPage);
+
+	// logs a new value for a catalog key; returns the LSN of the record
+	size_t logCatalog (string key, string value);
+
+	// makes everything that has been logged durable
+	void commit ();
+
+	// makes the log durable up to (at least) the given LSN
+	void flush (size_t lsn);
+
+	// the LSN of the end of the log, and how much of the log is durable
+	size_t getLSN ();
+	size_t getDurableLSN ();
+
+	// the number of times that the log has been written and synced, and the number of bytes written
+	size_t getNumFlushes ();
+	size_t getNumBytesWritten ();
+
+	// redoes everything in the log: the pages are written straight to the table files (with
+	// checksums, if pageChecksums is true; see MyDB_BufferManager :: setPageChecksums), which
+	// are then synced, and the catalog entries are put into the catalog, which is then saved.
+	// Then the log is cleared out.  This has to be done before the buffer manager touches any
+	// of the tables, and before the catalog is set up to log its changes.  Returns the number
+	// of page changes and catalog entries that were redone
+	size_t recover (MyDB_CatalogPtr catalog, bool pageChecksums);
+
+	// writes every dirty page of a table to disk, saves the catalog, and then clears out the
+	// log, so that recovery starts from here
+	void checkpoint (MyDB_BufferManager &buffer, MyDB_CatalogPtr catalog);
+
+private:
+
+	// adds a record (its payload, then the data, and then the tail) to the buffer, handing the
+	// buffer to the writer first if it is full; the lock must be held, and is dropped if this
+	// has to wait.  Returns the LSN of the end of the record
+	size_t append (unique_lock <mutex> &guard, MyDB_LogRecordType type, const void *payload, size_t payloadSize,
+		const void *data = nullptr, size_t dataSize = 0, const void *tail = nullptr, size_t tailSize = 0);
+
+	// hands the buffered records to the writer, unless he is still writing the last ones, in
+	// which case this waits for him to finish; the lock must be held
+	void startWrite (unique_lock <mutex> &guard);
+
+	// what the writer does: writes and syncs the buffers that are handed to him
+	void writeLoop ();
+
+	// the id of the table, logging a Table record if it has not been seen since the last
+	// checkpoint; the lock must be held
+	uint32_t tableID (unique_lock <mutex> &guard, MyDB_TablePtr whichTable);
+
+	// empties out the log file and starts it over with a Start record; the lock must be held,
+	// and anything that is buffered is thrown away
+	void clearLog (unique_lock <mutex> &guard);
+
+	// the log file
+	string fName;
+	int fd;
+
+	size_t pageSize;
+	size_t bufferSize;
+
+	// protects everything below
+	mutex lock;
+
+	// the records that have not been written yet, and the buffer that is being written
+	vector <char> buffer;
+	vector <char> writing;
+
+	// the LSN at the start of the file, of the end of the log, and of the end of what is durable
+	size_t firstLSN;
+	size_t nextLSN;
+	size_t durableLSN;
+
+	// false until the log file has been cleared out and started over, which is put off until
+	// it is recovered or something is logged
+	bool started;
+
+	// true while the writer has a buffer to write; writeNeeded is signalled when he is given
+	// one (or is told that he is done), and flushed when he has written it
+	bool flushing;
+	bool done;
+	condition_variable writeNeeded;
+	condition_variable flushed;
+	thread writer;
+
+	// where the payload of a record is put together
+	string scratch;
+
+	// where the last record in the buffer starts, and the CRC32C of everything in it but its tail
+	size_t lastRecord;
+	uint32_t lastRecordCRC;
+
+	// if the last record in the buffer is a PageWrite that can be added to, where it starts
+	// (NO_RECORD otherwise), the page that it is for, where its bytes end on the page, and its
+	// number of header bytes
+	size_t lastWrite;
+	uint64_t lastWriteKey;
+	size_t lastWriteEnd;
+	size_t lastWriteHeader;
+
+	// the ids of the tables that have a Table record since the last checkpoint (keyed by file
+	// name), and the tables themselves, keyed by address, so that the common case does not
+	// need the name
+	unordered_map <string, uint32_t> tableIDs;
+	unordered_map <MyDB_Table *, uint32_t> knownTables;
+	vector <MyDB_TablePtr> tables;
+
+	// the pages (table id, page number) that have been logged in full, or cleared, since the
+	// last checkpoint, so that their changes can just be redone on top of that
+	unordered_set <uint64_t> loggedPages;
+
+	// the last page that logWrite found (or put) in loggedPages
+	uint64_t lastPageKey;
+
+	size_t numFlushes;
+	size_t numBytesWritten;
+};
+
+#endif
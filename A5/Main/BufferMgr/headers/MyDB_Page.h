@@ -12,7 +12,9 @@
 #ifndef PAGE_H
 #define PAGE_H
 
+#include <atomic>
 #include <memory>
+#include "MyDB_BufferStats.h"
 #include "MyDB_Table.h"
 #include <string>
 
@@ -28,8 +30,9 @@ class MyDB_Page {
 
 public:
 
-	// access the raw bytes in this page
-	void *getBytes (MyDB_PagePtr me);
+	// access the raw bytes in this page... this is nullptr if the page could not be read in,
+	// because every frame in its shard was pinned (see MyDB_BufferManager :: setFrameWait)
+	void *getBytes ();
 
 	// let the page know that we have written to the bytes
 	void wroteBytes ();
@@ -47,17 +50,20 @@ public:
 	// sets the bytes in the page
 	void setBytes (void *bytes, size_t numBytes);
 
-	// decrements the ref count
-	inline void decRefCount (MyDB_PagePtr me) {
-		refCount--;
-		if (refCount == 0) {
-			killpage (me);
+	// decrements the ref count... the last reference is dropped by the buffer manager, with
+	// the page locked, so that the page cannot be evicted (and freed) while this is going on
+	inline void decRefCount () {
+		int count = refCount.load ();
+		while (count > 1) {
+			if (refCount.compare_exchange_weak (count, count - 1))
+				return;
 		}
+		killpage ();
 	}
 
 	// increments the ref count
 	inline void incRefCount () {
-		refCount++;
+		refCount.fetch_add (1);
 	}
 
 	// get the parent
@@ -66,8 +72,8 @@ public:
 private:
 
 	friend class MyDB_BufferManager;
+	friend class MyDB_PageHandle;
 	friend class PageComp;
-	friend class CheckLRU;
 
 	// a pointer to the raw bytes
 	void *bytes;
@@ -75,8 +81,12 @@ private:
 	// the number of raw bytes available
 	size_t numBytes;
 
-	// tells us if this page needs to be written back
-	bool isDirty;	
+	// tells us if this page needs to be written back (this is set without any lock held)
+	atomic <bool> isDirty;	
+
+	// set for a temporary page whose bytes will not be read again, so that they can be
+	// dropped instead of written out when the page is evicted
+	atomic <bool> discardable;
 
 	// pointer to the parent buffer manager
 	MyDB_BufferManager& parent;		
@@ -88,14 +98,57 @@ private:
 	// this is the position of the page in the relation
 	size_t pos;
 
-	// this is the last time that the page had been accessed
-	long timeTick;
+	// the buffer manager's slot for myTable (0 for a temp page), the fd of that file, the
+	// buffer shard and memory pool that the page belongs to, and the statistics that it is
+	// counted in
+	size_t slot;
+	int fd;
+	unsigned pool;
+	size_t shard;
+	MyDB_TableCounters *counters;
+
+	// the buffer frame that holds the page's bytes; -1 if it is not buffered
+	long frame;
+
+	// true if the page belongs to a table that has been mapped read-only, in which case the
+	// bytes point right into the mapping, and the page never has a frame
+	bool mapped;
+
+	// the number of times that the page has been pinned and not unpinned... while this is
+	// not zero, the page is buffered and may not be evicted
+	atomic <int> pinCount;
+
+	// true while a synchronous read into the page's frame is going on, with the shard unlocked...
+	// this is set before the page is pinned, so a pinned page that is not loading is ready to use
+	atomic <bool> loading;
+
+	// true if the page was last asked for by a sequential scan
+	bool scanned;
+
+	// the ticket of the prefetch read into the page's frame, or -1 if there is none in
+	// flight; the bytes may not be touched until it is done
+	long readTicket;
+
+	// the ticket of the last background write of the page, or -1 if it is known to be
+	// done; the frame may not be reused until it is
+	long writeTicket;
+
+	// true if the page was prefetched and has not been accessed since
+	bool readAhead;
+
+	// the LSN of the last log record that describes a change to the page (zero if there is
+	// none); the page may not be written to disk until the log is durable up to here
+	atomic <size_t> lsn;
+
+	// the number of handles to the page
+	atomic <int> refCount;
 
-	// the number of references
-	int refCount;
+	// the page's pointer to itself, which keeps it alive while there are handles to it; it
+	// is set by the first handle, and cleared (with the shard locked) once the last one is gone
+	MyDB_PagePtr me;
 
 	// kill the page
-	void killpage (MyDB_PagePtr me);
+	void killpage ();
 };
 
 #endif
@@ -13,23 +13,26 @@
 #ifndef PAGE_HANDLE_H
 #define PAGE_HANDLE_H
 
+#include <cstddef>
 #include <memory>
 #include "MyDB_Page.h"
 #include "MyDB_Table.h"
 #include <string>
 
-// page handles are basically smart pointers
+// page handles are basically smart pointers... but they are plain values, not shared_ptrs
+// to a handle object, so getting one does not go to the heap.  The count of the handles to
+// a page lives in the page itself, and the page keeps itself alive while that count is not
+// zero, so copying a handle is a single atomic increment, and moving one is free
 using namespace std;
-class MyDB_PageHandleBase;
-typedef shared_ptr <MyDB_PageHandleBase> MyDB_PageHandle;
 
-class MyDB_PageHandleBase {
+class MyDB_PageHandle {
 
 public:
 
-	// access the raw bytes in this page
+	// access the raw bytes in this page... this is nullptr if the page could not be read in,
+	// because every frame in its shard was pinned (see MyDB_BufferManager :: setFrameWait)
 	void *getBytes () {
-		return page->getBytes (page);
+		return page->getBytes ();
 	}
 
 	// let the page know that we have written to the bytes.  Must always
@@ -40,34 +43,82 @@ public:
 		page->wroteBytes ();
 	}
 
+	// a hint that the bytes of this temporary page will not be read again (by anyone), so
+	// that if the page has to be evicted, it is dropped instead of written to the temp file...
+	// reading the page after it has been evicted gives back garbage.  This does nothing for
+	// a page of a table
+	void setDiscardable () {
+		page->discardable = true;
+	}
+
+	// pins the page, reading it in if need be, so that its bytes stay put until a matching
+	// call to unpin (or until there are no more handles to it); returns false if the buffer
+	// is entirely full of pinned pages
+	bool pin ();
+
+	// undoes one call to pin
+	void unpin ();
+
+	// tells the page that a change to its bytes was written to the write-ahead log with the
+	// given LSN, so that the page is not written to disk before the log is durable up to there
+	void setLSN (size_t lsn);
+
+	// a null handle is what getPinnedPage returns when the buffer is full
+	bool operator == (nullptr_t) const {
+		return page == nullptr;
+	}
+
+	bool operator != (nullptr_t) const {
+		return page != nullptr;
+	}
+
 	// There are no more references to the handle when this is called...
 	// this should decrmeent a reference count to the number of handles
 	// to the particular page that it references.  If the number of 
 	// references to a pinned page goes down to zero, then the page should
 	// become unpinned.  
-	~MyDB_PageHandleBase () {
-		page->decRefCount (page);
+	~MyDB_PageHandle () {
+		if (page != nullptr)
+			page->decRefCount ();
+	}
+
+	// a null handle
+	MyDB_PageHandle () : page (nullptr) {}
+
+	MyDB_PageHandle (nullptr_t) : page (nullptr) {}
+
+	MyDB_PageHandle (const MyDB_PageHandle &copyMe) : page (copyMe.page) {
+		if (page != nullptr)
+			page->incRefCount ();
+	}
+
+	MyDB_PageHandle (MyDB_PageHandle &&moveMe) : page (moveMe.page) {
+		moveMe.page = nullptr;
 	}
 
-	// sets up the page...
-	MyDB_PageHandleBase (MyDB_PagePtr useMe) {
-		page = useMe;
-		page->incRefCount ();
+	MyDB_PageHandle &operator = (MyDB_PageHandle copyMe) {
+		swap (page, copyMe.page);
+		return *this;
 	}
 
 private:
 
 	friend class MyDB_PageReaderWriter;
+	friend class MyDB_BufferManager;
+
+	// sets up the page... this must be called with the page's shard locked (or before
+	// anybody else can see the page), since the first handle is what makes it keep itself
+	MyDB_PageHandle (const MyDB_PagePtr &useMe) : page (useMe.get ()) {
+		if (page->refCount.fetch_add (1) == 0)
+			page->me = useMe;
+	}
 
 	// get the buffer manager
 	MyDB_BufferManager &getParent () {
 		return page->getParent ();
 	}
 
-	friend class CheckLRU;
-	friend class MyDB_BufferManager;
-	MyDB_PagePtr page;
+	MyDB_Page *page;
 };
 
 #endif
-
@@ -0,0 +1,68 @@
+
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// this lists all of the replacement policies that the buffer manager can use
+enum MyDB_ReplacementType {LRUReplacement, ClockReplacement, TwoQReplacement};
+
+class MyDB_ReplacementPolicy;
+typedef shared_ptr <MyDB_ReplacementPolicy> MyDB_ReplacementPolicyPtr;
+
+// a replacement policy decides which buffer frame to evict.  It only knows about
+// frame numbers in [0, numFrames); the buffer manager tells it when a frame starts
+// holding an evictable (unpinned) page, when that page is accessed, and when the
+// frame stops being evictable (because its page was pinned or killed).  Once a
+// sequential scan has moved past a page, the frame is demoted, so that the policy can
+// get rid of it before pages that are being reused
+class MyDB_ReplacementPolicy {
+
+public:
+
+	// the page in frame whichFrame can now be evicted... it was either just read in,
+	// or it was just unpinned.  whichPage identifies the page (the buffer manager's
+	// page key)
+	virtual void add (size_t whichFrame, uint64_t whichPage) = 0;
+
+	// the (evictable) page in frame whichFrame was just accessed
+	virtual void touch (size_t whichFrame) = 0;
+
+	// the (evictable) page in frame whichFrame was read by a scan that has moved on,
+	// so it will probably not be needed again... a later touch undoes this
+	virtual void demote (size_t whichFrame) = 0;
+
+	// the page in frame whichFrame can no longer be evicted
+	virtual void remove (size_t whichFrame) = 0;
+
+	// the page in frame whichFrame was pinned, so it cannot be evicted until the matching
+	// add... a policy that keeps pages in different queues can remember where the page was,
+	// so that being pinned for a while does not cost the page its standing
+	virtual void pin (size_t whichFrame) {
+		remove (whichFrame);
+	}
+
+	// chooses the frame to evict and forgets about it; returns -1 if there is
+	// no evictable frame
+	virtual long victim () = 0;
+
+	// appends to coldFrames up to num evictable frames, in about the order that they
+	// would be chosen as victims... this does not change anything, so that the buffer
+	// manager can look ahead at what is about to be evicted
+	virtual void coldest (size_t num, vector <size_t> &coldFrames) = 0;
+
+	// the buffer has been resized, so that only numFrames of the policy's frames are in use
+	// now... a policy that sizes its queues from the number of frames can adjust them
+	virtual void setNumFrames (size_t numFrames) {}
+
+	virtual ~MyDB_ReplacementPolicy () {}
+
+	// creates a policy of the given type over numFrames frames
+	static MyDB_ReplacementPolicyPtr create (MyDB_ReplacementType whichType, size_t numFrames);
+};
+
+#endif
@@ -0,0 +1,62 @@
+
+#ifndef TEMP_SPACE_H
+#define TEMP_SPACE_H
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// keeps track of which slots (page-sized pieces) of the temp file are in use.  Slots are
+// handed out in extents (runs of contiguous slots), so that a run of anonymous pages that
+// is written and read in order, like a sort run, sits in one piece on disk.  Free slots are
+// kept as extents too, which are merged with their neighbours as they are given back; once
+// the extent at the end of the file is free, the file is considered to end before it.
+// This only does the bookkeeping... it is up to the caller to actually shrink the file, or
+// punch holes in it, and to do any locking
+class MyDB_TempSpace {
+
+public:
+
+	// nothing is in use
+	MyDB_TempSpace ();
+
+	// hands out numSlots contiguous slots, from the lowest free extent that is big enough
+	// (or from the end of the file, if there is none); returns the first one
+	size_t allocate (size_t numSlots);
+
+	// gives back numSlots slots, starting with first
+	void release (size_t first, size_t numSlots);
+
+	// one past the last slot that is in use
+	size_t getEnd ();
+
+	// the number of free slots before the end
+	size_t getNumFree ();
+
+	// the number of slots that have been given back since the last call to takeHoles
+	size_t getNumReleased ();
+
+	// returns (first slot, number of slots) for each free extent of at least minSlots slots
+	// that has not been returned before, whose disk space can be given back to the OS
+	vector <pair <size_t, size_t>> takeHoles (size_t minSlots);
+
+private:
+
+	// a free extent, and whether its slots have already been returned by takeHoles
+	struct Extent {
+		size_t numSlots;
+		bool punched;
+	};
+
+	// the free extents, by first slot
+	map <size_t, Extent> freeExtents;
+
+	size_t end;
+	size_t numFree;
+	size_t numReleased;
+};
+
+#endif
@@ -0,0 +1,83 @@
+
+#ifndef TWO_Q_POLICY_H
+#define TWO_Q_POLICY_H
+
+#include <deque>
+#include "MyDB_ReplacementPolicy.h"
+#include "OpenHashTable.h"
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// 2Q replacement (Johnson and Shasha).  A page that is read for the first time goes on
+// the FIFO queue A1in, and repeated accesses while it is there do not count (they are
+// usually correlated, like a scan reading record after record from one page).  When a page
+// falls off of A1in, we remember its identity in the ghost queue A1out; if it is read again
+// while it is remembered, it has proven that it is being reused, and it goes on the LRU
+// queue Am.  Frames that a sequential scan is done with are demoted to their own FIFO
+// queue, which is always emptied first, and they never become ghosts... so a big scan
+// cannot push out Am
+class MyDB_TwoQPolicy : public MyDB_ReplacementPolicy {
+
+public:
+
+	MyDB_TwoQPolicy (size_t numFrames);
+
+	void add (size_t whichFrame, uint64_t whichPage) override;
+	void touch (size_t whichFrame) override;
+	void demote (size_t whichFrame) override;
+	void remove (size_t whichFrame) override;
+	void pin (size_t whichFrame) override;
+	long victim () override;
+	void coldest (size_t num, vector <size_t> &coldFrames) override;
+	void setNumFrames (size_t numFrames) override;
+
+private:
+
+	// the queues that a frame can be on
+	enum Queue {NoQueue = 0, ScanQueue, InQueue, MainQueue};
+
+	// each queue is an intrusive doubly-linked list over frame numbers, using prev
+	// and next below... the head is the most recently added frame
+	struct FrameList {
+		long head = -1;
+		long tail = -1;
+		size_t size = 0;
+	};
+	FrameList queues[4];
+	vector <long> prev;
+	vector <long> next;
+
+	// the queue that each frame is on
+	vector <char> onQueue;
+
+	// the queue that each pinned frame was on when it was pinned, so that it can go back
+	// there once it is unpinned
+	vector <char> pinnedFrom;
+
+	// the page that each frame holds
+	vector <uint64_t> pageOf;
+
+	// A1out... pairs of (page, sequence number) in FIFO order, plus the sequence number of
+	// the live entry for each remembered page, so that entries for pages that have come
+	// back into the buffer can be skipped lazily
+	deque <pair <uint64_t, uint64_t>> ghosts;
+	OpenHashTable <uint64_t> ghostSeqs;
+	uint64_t nextSeq;
+
+	// the target size of A1in, and the number of ghosts that we remember
+	size_t maxIn;
+	size_t maxGhosts;
+
+	// puts the frame at the head of the given queue
+	void pushHead (Queue whichQueue, size_t whichFrame);
+
+	// takes the frame off of whatever queue it is on
+	void unlink (size_t whichFrame);
+
+	// remembers that the given page was just kicked out of A1in
+	void addGhost (uint64_t whichPage);
+};
+
+#endif
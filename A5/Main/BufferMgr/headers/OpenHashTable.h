@@ -0,0 +1,145 @@
+
+#ifndef OPEN_HASH_TABLE_H
+#define OPEN_HASH_TABLE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// an open-addressing hash table keyed by 64-bit integers... this is used by the buffer
+// manager to map (table slot, page number) pairs to pages, so that a lookup is a hash plus
+// a short linear probe, and never allocates.  Removal uses backward shifting, so that there
+// are never any tombstones that slow down later probes
+template <class ValType>
+class OpenHashTable {
+
+public:
+
+	// creates a table that can hold initialCapacity / 2 items before it has to grow
+	OpenHashTable (size_t initialCapacity = 64) {
+		logCapacity = 1;
+		while (((size_t) 1 << logCapacity) < initialCapacity)
+			logCapacity++;
+		slots.resize ((size_t) 1 << logCapacity);
+		numItems = 0;
+	}
+
+	// returns a pointer to the value associated with key, or a nullptr if there is none...
+	// the pointer is only good until the next insert or remove
+	inline ValType *find (uint64_t key) {
+		size_t mask = slots.size () - 1;
+		for (size_t i = home (key); slots[i].used; i = (i + 1) & mask) {
+			if (slots[i].key == key)
+				return &(slots[i].val);
+		}
+		return nullptr;
+	}
+
+	// associates val with key, replacing whatever was there
+	void insert (uint64_t key, ValType val) {
+
+		// keep the load factor at or below 1/2 so that probes stay short
+		if (2 * (numItems + 1) > slots.size ())
+			grow ();
+
+		size_t mask = slots.size () - 1;
+		size_t i = home (key);
+		for (; slots[i].used; i = (i + 1) & mask) {
+			if (slots[i].key == key) {
+				slots[i].val = std :: move (val);
+				return;
+			}
+		}
+
+		slots[i].used = true;
+		slots[i].key = key;
+		slots[i].val = std :: move (val);
+		numItems++;
+	}
+
+	// removes key from the table; returns false if it was not there
+	bool remove (uint64_t key) {
+
+		// find the guy
+		size_t mask = slots.size () - 1;
+		size_t i = home (key);
+		while (true) {
+			if (!slots[i].used)
+				return false;
+			if (slots[i].key == key)
+				break;
+			i = (i + 1) & mask;
+		}
+
+		// and now shift back everyone in the probe sequence that would otherwise be cut off
+		size_t j = i;
+		while (true) {
+			j = (j + 1) & mask;
+			if (!slots[j].used)
+				break;
+
+			// if the guy at j lives cyclically in (i, j], he can stay where he is
+			size_t k = home (slots[j].key);
+			if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+				continue;
+
+			slots[i].key = slots[j].key;
+			slots[i].val = std :: move (slots[j].val);
+			i = j;
+		}
+
+		slots[i].used = false;
+		slots[i].val = ValType ();
+		numItems--;
+		return true;
+	}
+
+	// calls f (key, val) on every item in the table; f must not insert or remove
+	template <class Func>
+	void forEach (Func f) {
+		for (auto &s : slots) {
+			if (s.used)
+				f (s.key, s.val);
+		}
+	}
+
+	// the number of items in the table
+	size_t size () {
+		return numItems;
+	}
+
+private:
+
+	struct Slot {
+		uint64_t key = 0;
+		bool used = false;
+		ValType val = ValType ();
+	};
+
+	// fibonacci hashing... the high bits of the product are well mixed even when the
+	// keys are consecutive page numbers
+	inline size_t home (uint64_t key) {
+		return (size_t) ((key * 0x9E3779B97F4A7C15ULL) >> (64 - logCapacity));
+	}
+
+	// doubles the size of the table
+	void grow () {
+		vector <Slot> oldSlots;
+		oldSlots.swap (slots);
+		logCapacity++;
+		slots.resize ((size_t) 1 << logCapacity);
+		numItems = 0;
+		for (auto &s : oldSlots) {
+			if (s.used)
+				insert (s.key, std :: move (s.val));
+		}
+	}
+
+	vector <Slot> slots;
+	size_t numItems;
+	int logCapacity;
+};
+
+#endif
@@ -13,10 +13,21 @@
 #ifndef BUFFER_MGR_C
 #define BUFFER_MGR_C
 
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <fcntl.h>
+#include <fstream>
 #include <iostream>
 #include "MyDB_BufferManager.h"
+#include "MyDB_Checksum.h"
+#include "MyDB_FileIO.h"
 #include "MyDB_Page.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -28,168 +39,1217 @@ size_t MyDB_BufferManager :: getPageSize () {
 	return pageSize;
 }
 
-MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
-		
-	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
+size_t MyDB_BufferManager :: getNumHits () {
+	lock_guard <mutex> guard (tableLock);
+	size_t total = 0;
+	for (auto &counters : tableCounters)
+		total += counters->numHits;
+	return total;
+}
+
+size_t MyDB_BufferManager :: getNumMisses () {
+	lock_guard <mutex> guard (tableLock);
+	size_t total = 0;
+	for (auto &counters : tableCounters)
+		total += counters->numMisses;
+	return total;
+}
+
+MyDB_BufferStats MyDB_BufferManager :: getStats () {
+
+	MyDB_BufferStats stats;
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		stats.numEvictionWrites += shard->numEvictionWrites;
+		stats.numBackgroundWrites += shard->numBackgroundWrites;
+		stats.numAvoidedWrites += shard->numAvoidedWrites;
+	}
+
+	// every table object with a given name shares that name's slot, so the names are unique
+	{
+		lock_guard <mutex> guard (tableLock);
+		for (size_t slot = 0; slot < tableCounters.size (); slot++) {
+			MyDB_TableStats tableStats;
+			tableCounters[slot]->snapshot (tableStats);
+			string name = (slot == 0 ? "<temp>" : slotTables[slot]->getName ());
+			stats.byTable[name] = tableStats;
+			stats.total.add (tableStats);
+		}
+	}
+
+	{
+		lock_guard <mutex> guard (tempLock);
+		stats.tempFileSize = tempFileSize;
+		stats.maxTempFileSize = maxTempFileSize;
+		stats.tempFileGrowth = tempFileGrowth;
+	}
+
+	for (auto &pool : pools) {
+		MyDB_PoolStats &poolStats = stats.byPool[pool->name];
+		poolStats.numFrames = pool->numFrames;
+		poolStats.minFrames = pool->minFrames;
+		poolStats.maxFrames = pool->maxFrames;
+	}
+
+	stats.numFrames = numPages;
+	stats.numPinned = numPinnedFrames;
+	stats.maxPinned = maxPinnedFrames;
+	return stats;
+}
+
+void MyDB_BufferManager :: startTrace (string fName) {
+	stopTrace ();
+	trace = MyDB_TraceWriterPtr (new MyDB_TraceWriter (fName, pageSize));
+	lock_guard <mutex> guard (tableLock);
+	for (size_t slot = 1; slot < slotTables.size (); slot++)
+		trace->nameSlot (slot, slotTables[slot]->getName ());
+	tracing = true;
+}
+
+void MyDB_BufferManager :: stopTrace () {
+	tracing = false;
+	trace = nullptr;
+}
+
+size_t MyDB_BufferManager :: getNumEvictionWrites () {
+	size_t total = 0;
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		total += shard->numEvictionWrites;
+	}
+	return total;
+}
+
+size_t MyDB_BufferManager :: getNumBackgroundWrites () {
+	size_t total = 0;
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		total += shard->numBackgroundWrites;
+	}
+	return total;
+}
+
+size_t MyDB_BufferManager :: getNumAvoidedWrites () {
+	size_t total = 0;
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		total += shard->numAvoidedWrites;
+	}
+	return total;
+}
+
+size_t MyDB_BufferManager :: getNumShards () {
+	return shards.size ();
+}
+
+size_t MyDB_BufferManager :: getNumPages () {
+	return numPages;
+}
+
+size_t MyDB_BufferManager :: getMaxPages () {
+	return maxPages;
+}
+
+size_t MyDB_BufferManager :: resize (size_t newNumPages) {
+
+	// nothing can be reserved while the buffer is being resized, and the buffer cannot go
+	// below what has been reserved, or what the pools have been promised
+	lock_guard <mutex> reservationGuard (reservationLock);
+	size_t totalMin = 0;
+	for (auto &pool : pools)
+		totalMin += pool->minFrames;
+	newNumPages = max (newNumPages, shards.size () + max (numReservedFrames, totalMin));
+	newNumPages = min (newNumPages, maxPages);
+
+	size_t total = 0;
+	for (size_t s = 0; s < shards.size (); s++) {
+		Shard &shard = *shards[s];
+		lock_guard <mutex> guard (shard.lock);
+		size_t oldActive = shard.numActive;
+		size_t numActive = min (shard.numFrames, (s + 1) * newNumPages / shards.size () - s * newNumPages / shards.size ());
+		setNumActive (shard, numActive);
+
+		// new frames can be used right away (except for any that still have a page from
+		// before the buffer last shrank, which are freed when that page goes)
+		if (numActive > oldActive) {
+			for (size_t i = shard.firstFrame + numActive; i > shard.firstFrame + oldActive; i--) {
+				if (frameOwners[i - 1] == nullptr)
+					shard.availableFrames.push_back (i - 1);
+			}
+			frameFreed (shard);
+
+		// the free frames that are going away give their memory back now, and so do the frames
+		// with pages that can be evicted
+		} else if (numActive < oldActive) {
+			size_t numKept = 0;
+			for (size_t whichFrame : shard.availableFrames) {
+				if (isRetired (shard, whichFrame))
+					frameArena->discard (whichFrame, 1);
+				else
+					shard.availableFrames[numKept++] = whichFrame;
+			}
+			shard.availableFrames.resize (numKept);
+
+			reapReads (shard, false);
+			for (size_t i = shard.firstFrame + numActive; i < shard.firstFrame + oldActive; i++) {
+				if (frameOwners[i] != nullptr)
+					checkRetired (shard, frameOwners[i]);
+			}
+		}
+		total += numActive;
+	}
+
+	numPages = total;
+	return total;
+}
+
+size_t MyDB_BufferManager :: getMemoryBudget () {
+
+	// an explicit budget
+	const char *budget = getenv ("MYDB_BUFFER_MEMORY");
+	if (budget != nullptr) {
+		char *end;
+		double numBytes = strtod (budget, &end);
+		switch (toupper (*end)) {
+			case 'G': numBytes *= 1024;	// and fall through
+			case 'M': numBytes *= 1024;	// and fall through
+			case 'K': numBytes *= 1024;
+		}
+		if (numBytes >= 1)
+			return (size_t) numBytes;
+	}
+
+	// otherwise, a share of the machine's memory, or of the cgroup limit (version 2, then
+	// version 1) if that is lower... a limit of "max" does not parse, and so is skipped
+	size_t memory = (size_t) sysconf (_SC_PHYS_PAGES) * (size_t) sysconf (_SC_PAGE_SIZE);
+	for (const char *limitFile : {"/sys/fs/cgroup/memory.max", "/sys/fs/cgroup/memory/memory.limit_in_bytes"}) {
+		ifstream limitIn (limitFile);
+		size_t limit;
+		if (limitIn >> limit && limit < memory)
+			memory = limit;
+	}
+	return memory / MEMORY_BUDGET_SHARE;
+}
+
+size_t MyDB_BufferManager :: resizeToBudget () {
+	return resize (getMemoryBudget () / pageSize);
+}
+
+MyDB_FrameReservationPtr MyDB_BufferManager :: reserveFrames (size_t minFrames, size_t maxFrames, bool waitForFrames) {
+	unique_lock <mutex> guard (reservationLock);
+	minFrames = max (minFrames, (size_t) 1);
+	maxFrames = max (minFrames, maxFrames);
+	if (minFrames > getNumReservableFrames ())
+		return nullptr;
+
+	// wait for enough of the other reservations to be given back
+	while (getNumReservableFrames () - numReservedFrames < minFrames) {
+		if (!waitForFrames)
+			return nullptr;
+		reservationsReleased.wait (guard);
+	}
+
+	size_t numGranted = min (maxFrames, getNumReservableFrames () - numReservedFrames);
+	numReservedFrames += numGranted;
+	return MyDB_FrameReservationPtr (new MyDB_FrameReservation (*this, numGranted));
+}
+
+void MyDB_BufferManager :: releaseFrames (size_t numFrames) {
+	lock_guard <mutex> guard (reservationLock);
+	numReservedFrames -= numFrames;
+	reservationsReleased.notify_all ();
+}
+
+size_t MyDB_BufferManager :: getNumReservedFrames () {
+	lock_guard <mutex> guard (reservationLock);
+	return numReservedFrames;
+}
+
+size_t MyDB_BufferManager :: getNumReservableFrames () {
+	return numPages - shards.size ();
+}
+
+void MyDB_BufferManager :: setFrameWait (size_t millis) {
+	frameWaitMillis = millis;
+}
+
+bool MyDB_BufferManager :: createPool (string name, size_t minFrames, size_t maxFrames) {
+	size_t totalMin = minFrames;
+	for (auto &pool : pools)
+		totalMin += pool->minFrames;
+	if (findPool (name) != -1 || pools.size () == MAX_BUFFER_POOLS || totalMin > getNumReservableFrames ())
+		return false;
+
+	pools.push_back (unique_ptr <Pool> (new Pool));
+	pools.back ()->name = name;
+	pools.back ()->minFrames = minFrames;
+	pools.back ()->maxFrames = max (minFrames, maxFrames);
+	pools.back ()->numFrames = 0;
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		shard->policies.push_back (MyDB_ReplacementPolicy :: create (replacement, shard->numFrames));
+		shard->policies.back ()->setNumFrames (shard->numActive);
+		shard->lastUse.push_back (0);
+	}
+	return true;
+}
+
+bool MyDB_BufferManager :: setPool (MyDB_TablePtr whichTable, string poolName) {
+	long pool = findPool (poolName);
+	if (pool == -1)
+		return false;
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+	lock_guard <mutex> guard (tableLock);
+	files[slot].pool = pool;
+	return true;
+}
+
+bool MyDB_BufferManager :: setTempPool (string poolName) {
+	long pool = findPool (poolName);
+	if (pool == -1)
+		return false;
+	tempPool = pool;
+	return true;
+}
+
+size_t MyDB_BufferManager :: getPoolSize (string poolName) {
+	long pool = findPool (poolName);
+	return pool == -1 ? 0 : (size_t) pools[pool]->numFrames;
+}
+
+long MyDB_BufferManager :: findPool (string name) {
+	for (size_t p = 0; p < pools.size (); p++) {
+		if (pools[p]->name == name)
+			return p;
+	}
+	return -1;
+}
+
+bool MyDB_BufferManager :: usesDirectIO () {
+	return directIO;
+}
+
+void MyDB_BufferManager :: setPageChecksums (bool onOrOff) {
+	pageChecksums = onOrOff && pageSize >= PAGE_CHECKSUM_OFFSET + sizeof (uint32_t);
+}
+
+bool MyDB_BufferManager :: usesPageChecksums () {
+	return pageChecksums;
+}
+
+void MyDB_BufferManager :: setLog (MyDB_LogManagerPtr logIn) {
+	log = logIn;
+}
+
+MyDB_LogManagerPtr MyDB_BufferManager :: getLog () {
+	return log;
+}
+
+void MyDB_BufferManager :: writeBackAll () {
+
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		vector <MyDB_PagePtr> writeMe;
+		for (size_t i = shard->firstFrame; i < shard->firstFrame + shard->numFrames; i++) {
+			MyDB_PagePtr &page = frameOwners[i];
+			if (page != nullptr && page->myTable != nullptr && page->isDirty && !page->loading) {
+				finishWrite (page);
+				writeMe.push_back (page);
+			}
+		}
+		writeBack (writeMe, false);
 	}
 
+	if (ioThread != nullptr) {
+		ioThread->drain ();
+		checkBackgroundIO ();
+	}
+
+	lock_guard <mutex> guard (tableLock);
+	for (size_t slot = 1; slot < files.size (); slot++) {
+		if (files[slot].fd != -1 && fsync (files[slot].fd) != 0) {
+			cout << "Can't sync " << slotTables[slot]->getStorageLoc () << ": " << lastIOError () << "\n";
+			exit (1);
+		}
+	}
+}
+
+void MyDB_BufferManager :: setCleanFraction (double fraction) {
+	cleanFraction = fraction;
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		shard->numToClean = (size_t) (fraction * shard->numActive);
+		shard->evictionsSinceClean = 0;
+	}
+}
+
+void MyDB_BufferManager :: setNumActive (Shard &shard, size_t numActive) {
+	shard.numActive = numActive;
+	for (auto &policy : shard.policies)
+		policy->setNumFrames (numActive);
+
+	// prefetching may tie up at most a quarter of the buffer
+	shard.maxPendingReads = numActive / 4 > 0 ? numActive / 4 : 1;
+	shard.numToClean = (size_t) (cleanFraction * numActive);
+}
+
+MyDB_IOThreadPtr MyDB_BufferManager :: getIOThread () {
+	call_once (ioThreadCreated, [this] { ioThread = make_shared <MyDB_IOThread> (); });
+	return ioThread;
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i, bool sequentialScan) {
+
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
 		cout << "Can't allocate a page with a null table!!\n";
 		exit (1);
 	}
-	
-	// next, see if the page is already in existence
-	pair <MyDB_TablePtr, long> whichPage = make_pair (whichTable, i);
-	if (allPages.count (whichPage) == 0) {
+
+	// open the file, if it is not open
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+
+	// next, see if the page is already in existence... the handle is made with the shard
+	// locked, so that the page cannot be killed out from under it
+	Shard &shard = *shards[shardFor (slot, i)];
+	lock_guard <mutex> guard (shard.lock);
+	MyDB_PagePtr *found = shard.pages.find (pageKey (slot, i));
+	if (found == nullptr) {
 
 		// it is not there, so create a page
-		MyDB_PagePtr returnVal = make_shared <MyDB_Page> (whichTable, i, *this);
-		allPages [whichPage] = returnVal;
-		return make_shared <MyDB_PageHandleBase> (returnVal);
+		MyDB_PagePtr returnVal = makePage (whichTable, i, slot, file);
+		returnVal->scanned = sequentialScan;
+		return MyDB_PageHandle (returnVal);
+	}
+
+	// it is there, so return it... if this request is not from a scan, then the page
+	// is being reused and is not a scan page any more
+	if (!sequentialScan)
+		(*found)->scanned = false;
+	return MyDB_PageHandle (*found);
+}
+
+void MyDB_BufferManager :: prefetch (MyDB_TablePtr whichTable, long first, long num, bool sequentialScan) {
+
+	// make sure we don't have a null table
+	if (whichTable == nullptr) {
+		cout << "Can't prefetch a page with a null table!!\n";
+		exit (1);
+	}
+
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+
+	// the pages of a mapped table are never read into the buffer... we just let the OS know
+	// that they are going to be needed
+	if (file.mapping != nullptr && first < (long) file.numMappedPages) {
+		long numMapped = min (num, (long) file.numMappedPages - first);
+		size_t start = first * pageSize / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+		madvise (file.mapping + start, (first + numMapped) * pageSize - start, MADV_WILLNEED);
+		first += numMapped;
+		num -= numMapped;
+	}
+	if (num <= 0)
+		return;
+	MyDB_IOThreadPtr reader = getIOThread ();
+
+	// get rid of the reads that are done, so they do not count against the budget
+	for (auto &shard : shards) {
+		lock_guard <mutex> guard (shard->lock);
+		reapReads (*shard, false);
+	}
+
+	// the pages are spread out over the shards, so each one is handled with its own shard locked
+	for (long i = first; i < first + num; i++) {
+
+		// if the shard is at its budget, skip the page
+		Shard &shard = *shards[shardFor (slot, i)];
+		unique_lock <mutex> guard (shard.lock);
+		if (shard.pendingReads.size () >= shard.maxPendingReads)
+			continue;
+
+		// if the page is already buffered (or being read), there is nothing to do
+		uint64_t whichPage = pageKey (slot, i);
+		MyDB_PagePtr *found = shard.pages.find (whichPage);
+		if (found != nullptr && (*found)->bytes != nullptr)
+			continue;
+
+		// get some RAM for the page... this never waits, so if every frame is busy, skip it
+		if (shard.availableFrames.size () == 0) {
+			findColdFrames (shard, 1);
+			if (shard.coldFrames.size () == 0)
+				continue;
+		}
+		long whichFrame = getFrame (shard, guard, file.pool);
+		if (whichFrame == -1)
+			continue;
+
+		MyDB_PagePtr readMe;
+		found = shard.pages.find (whichPage);
+		if (found == nullptr) {
+			readMe = makePage (whichTable, i, slot, file);
+			readMe->scanned = sequentialScan;
+		} else if ((*found)->bytes != nullptr) {
+			freeFrame (shard, whichFrame);
+			continue;
+		} else {
+			readMe = *found;
+			if (!sequentialScan)
+				readMe->scanned = false;
+		}
+
+		// and start the read... the page is not evictable until it is done
+		assignFrame (readMe, whichFrame);
+		readMe->readTicket = reader->read (file.fd, i * pageSize, readMe->bytes, pageSize, file.counters);
+		file.counters->numPrefetches++;
+		traceEvent (MyDB_TraceEventType :: Prefetch, *readMe);
+		readMe->readAhead = true;
+		shard.pendingReads.push_back (readMe);
+	}
+}
+
+void MyDB_BufferManager :: readPage (MyDB_PagePtr readMe) {
+	auto start = chrono :: steady_clock :: now ();
+	if (!readFully (readMe->fd, readMe->bytes, pageSize, readMe->pos * pageSize)) {
+		cout << "Can't read page " << readMe->pos << " of " << getFileName (readMe->slot) << ": " << lastIOError () << "\n";
+		exit (1);
+	}
+	readMe->counters->countRead (pageSize, chrono :: duration <double, micro> (chrono :: steady_clock :: now () - start).count ());
+	checkPage (readMe);
+}
+
+void MyDB_BufferManager :: checkPage (MyDB_PagePtr readMe) {
+	if (pageChecksums && !pageChecksumOK (readMe->bytes, pageSize)) {
+		cout << "Page " << readMe->pos << " of " << getFileName (readMe->slot) << " is corrupt: its checksum is "
+			<< storedChecksum (readMe->bytes) << ", but its contents add up to " << pageChecksum (readMe->bytes, pageSize)
+			<< " (use verifyTable to check the whole file)\n";
+		exit (1);
+	}
+}
+
+void MyDB_BufferManager :: checkBackgroundIO () {
+	if (ioThread->failed ()) {
+		cout << "Background I/O failed: " << ioThread->getError () << "\n";
+		exit (1);
+	}
+}
+
+string MyDB_BufferManager :: getFileName (size_t slot) {
+	if (slot == 0)
+		return tempFile;
+	lock_guard <mutex> guard (tableLock);
+	return slotTables[slot]->getStorageLoc ();
+}
+
+int MyDB_BufferManager :: openFile (string fName, int flags) {
+
+	// some file systems (tmpfs, for one) will not even open a file for direct I/O
+	int fd = -1;
+#ifdef O_DIRECT
+	if (directIO)
+		fd = open (fName.c_str (), flags | O_DIRECT, 0666);
+#endif
+	if (fd == -1)
+		fd = open (fName.c_str (), flags, 0666);
+	if (fd == -1) {
+		cout << "Can't open " << fName << ": " << lastIOError () << "\n";
+		exit (1);
+	}
+	return fd;
+}
+
+void MyDB_BufferManager :: finishRead (Shard &shard, MyDB_PagePtr readMe) {
+	ioThread->wait (readMe->readTicket);
+	checkBackgroundIO ();
+	readMe->readTicket = -1;
+	checkPage (readMe);
+	if (readMe->pinCount == 0)
+		policyFor (shard, *readMe)->add (readMe->frame - shard.firstFrame, pageKey (readMe->slot, readMe->pos));
+}
+
+void MyDB_BufferManager :: reapReads (Shard &shard, bool waitForAll) {
+	while (shard.pendingReads.size () > 0) {
+		MyDB_PagePtr readMe = shard.pendingReads.front ();
+		if (readMe->readTicket != -1) {
+			if (!waitForAll && !ioThread->isDone (readMe->readTicket))
+				return;
+			finishRead (shard, readMe);
+		}
+		shard.pendingReads.pop_front ();
+	}
+}
+
+void MyDB_BufferManager :: finishWrite (MyDB_PagePtr writeMe) {
+	if (writeMe->writeTicket != -1) {
+		ioThread->wait (writeMe->writeTicket);
+		checkBackgroundIO ();
+		writeMe->writeTicket = -1;
+	}
+}
+
+void MyDB_BufferManager :: writeBack (vector <MyDB_PagePtr> &writeMe, bool inBackground) {
+
+	// the log has to be on disk before the pages that it describes
+	if (log != nullptr) {
+		size_t lsn = 0;
+		for (auto &page : writeMe)
+			lsn = max (lsn, (size_t) page->lsn);
+		if (lsn > 0)
+			log->flush (lsn);
+	}
+
+	// sort by file and then by position, so that pages that are next to each other
+	// on disk can go out with a single call
+	sort (writeMe.begin (), writeMe.end (), [] (const MyDB_PagePtr &a, const MyDB_PagePtr &b) {
+		return a->slot < b->slot || (a->slot == b->slot && a->pos < b->pos);
+	});
+
+	vector <iovec> pieces;
+	for (size_t start = 0; start < writeMe.size (); ) {
+
+		// find the run of adjacent pages that starts here
+		size_t end = start + 1;
+		while (end < writeMe.size () && end - start < IOV_MAX && writeMe[end]->slot == writeMe[start]->slot &&
+			writeMe[end]->pos == writeMe[end - 1]->pos + 1)
+			end++;
+
+		// a page that is written in the background can still be changed before the I/O thread
+		// gets to it, and then the checksum would not match what lands on disk... so when
+		// there are checksums, the run is copied, and the copy is checksummed and written
+		char *copy = nullptr;
+		if (inBackground && pageChecksums) {
+			void *mem;
+			if (posix_memalign (&mem, FRAME_ALIGNMENT, (end - start) * pageSize) != 0) {
+				cout << "Can't allocate " << (end - start) * pageSize << " bytes to write pages from\n";
+				exit (1);
+			}
+			copy = (char *) mem;
+		}
+
+		pieces.clear ();
+		for (size_t i = start; i < end; i++) {
+			iovec piece;
+			piece.iov_base = writeMe[i]->bytes;
+			piece.iov_len = pageSize;
+			if (copy != nullptr) {
+				piece.iov_base = copy + (i - start) * pageSize;
+				memcpy (piece.iov_base, writeMe[i]->bytes, pageSize);
+			}
+			if (pageChecksums)
+				setPageChecksum (piece.iov_base, pageSize);
+			pieces.push_back (piece);
+
+			// if somebody writes the page after this, he will dirty it again
+			writeMe[i]->isDirty = false;
+			writeMe[i]->counters->numWriteBacks++;
+			traceEvent (MyDB_TraceEventType :: WriteBack, *writeMe[i]);
+		}
+
+		// and write it
+		int fd = writeMe[start]->fd;
+		size_t offset = writeMe[start]->pos * pageSize;
+		MyDB_TableCounters *counters = writeMe[start]->counters;
+		if (inBackground) {
+			size_t ticket = ioThread->write (fd, offset, pieces, counters, copy);
+			for (size_t i = start; i < end; i++)
+				writeMe[i]->writeTicket = ticket;
+		} else {
+			auto startTime = chrono :: steady_clock :: now ();
+			if (!writeFully (fd, pieces.data (), (int) pieces.size (), offset)) {
+				cout << "Can't write page " << writeMe[start]->pos << " of " << getFileName (writeMe[start]->slot) << ": "
+					<< lastIOError () << "\n";
+				exit (1);
+			}
+			counters->countWrite ((end - start) * pageSize,
+				chrono :: duration <double, micro> (chrono :: steady_clock :: now () - startTime).count ());
+		}
+
+		start = end;
+	}
+}
+
+void MyDB_BufferManager :: cleanColdFrames (Shard &shard) {
+
+	// find the dirty pages that are up next for eviction, and are not already being written
+	findColdFrames (shard, shard.numToClean);
+	vector <MyDB_PagePtr> writeMe;
+	for (size_t whichFrame : shard.coldFrames) {
+		MyDB_PagePtr page = frameOwners[whichFrame + shard.firstFrame];
+		if (page->writeTicket != -1 && ioThread->isDone (page->writeTicket))
+			page->writeTicket = -1;
+		if (page->isDirty && page->writeTicket == -1 && !isDead (page))
+			writeMe.push_back (page);
+	}
+
+	if (writeMe.size () == 0)
+		return;
+
+	getIOThread ();
+	shard.numBackgroundWrites += writeMe.size ();
+	writeBack (writeMe, true);
+}
+
+MyDB_PagePtr MyDB_BufferManager :: makePage (MyDB_TablePtr whichTable, long i, size_t slot, FileInfo &file) {
+	MyDB_PagePtr page = make_shared <MyDB_Page> (whichTable, i, *this);
+	page->slot = slot;
+	page->fd = file.fd;
+	page->shard = shardFor (slot, i);
+	page->pool = file.pool;
+	page->counters = file.counters;
+
+	// a page of a mapped table just points into the mapping
+	if (file.mapping != nullptr && (size_t) i < file.numMappedPages) {
+		page->mapped = true;
+		page->bytes = file.mapping + i * pageSize;
+		page->numBytes = pageSize;
+	}
+
+	shards[page->shard]->pages.insert (pageKey (slot, i), page);
+	return page;
+}
+
+size_t MyDB_BufferManager :: getSlot (MyDB_TablePtr forMe, FileInfo &file) {
+
+	lock_guard <mutex> guard (tableLock);
+
+	// the common case: we have seen this very table object before
+	size_t *found = tableSlots.find ((uint64_t) forMe.get ());
+	if (found != nullptr) {
+		file = files[*found];
+		return *found;
+	}
+
+	// see if some other object for the same table already has a slot
+	size_t slot;
+	for (slot = 1; slot < slotTables.size (); slot++) {
+		if (slotTables[slot]->getName () == forMe->getName ())
+			break;
+	}
+
+	// if not, then this is a new file
+	if (slot == slotTables.size ()) {
+		slotTables.push_back (forMe);
+		tableCounters.push_back (unique_ptr <MyDB_TableCounters> (new MyDB_TableCounters));
+		files.push_back (FileInfo ());
+		files.back ().fd = openFile (forMe->getStorageLoc (), O_CREAT | O_RDWR);
+		files.back ().counters = tableCounters.back ().get ();
+		if (tracing)
+			trace->nameSlot (slot, forMe->getName ());
 	}
 
-	// it is there, so return it
-	return make_shared <MyDB_PageHandleBase> (allPages [whichPage]);
+	tableSlots.insert ((uint64_t) forMe.get (), slot);
+	knownTables.push_back (forMe);
+	file = files[slot];
+	return slot;
+}
+
+bool MyDB_BufferManager :: mapReadOnly (MyDB_TablePtr whichTable) {
+
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+	lock_guard <mutex> guard (tableLock);
+	if (files[slot].mapping != nullptr)
+		return true;
+
+	// only the whole pages that are in the file right now get mapped
+	struct stat info;
+	if (fstat (file.fd, &info) != 0 || info.st_size < (off_t) pageSize)
+		return false;
+	size_t numMappedPages = info.st_size / pageSize;
+	void *mapping = mmap (nullptr, numMappedPages * pageSize, PROT_READ, MAP_SHARED, file.fd, 0);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	files[slot].mapping = (char *) mapping;
+	files[slot].numMappedPages = numMappedPages;
+	return true;
+}
+
+void MyDB_BufferManager :: startScan (MyDB_TablePtr whichTable) {
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+	lock_guard <mutex> guard (tableLock);
+	if (files[slot].mapping != nullptr && files[slot].numScans++ == 0)
+		madvise (files[slot].mapping, files[slot].numMappedPages * pageSize, MADV_SEQUENTIAL);
+}
+
+void MyDB_BufferManager :: finishScan (MyDB_TablePtr whichTable) {
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+	lock_guard <mutex> guard (tableLock);
+	if (files[slot].mapping != nullptr && --files[slot].numScans == 0)
+		madvise (files[slot].mapping, files[slot].numMappedPages * pageSize, MADV_NORMAL);
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPage () {
 
-	// open the file, if it is not open
-	if (fds.count (nullptr) == 0) {
-		int fd = open (tempFile.c_str (), O_TRUNC | O_CREAT | O_RDWR, 0666);
-		fds[nullptr] = fd;
+	// find a slot in the temp file
+	size_t slot;
+	{
+		lock_guard <mutex> guard (tempLock);
+		slot = tempSpace.allocate (1);
+		checkTempGrowth ();
 	}
+	return makeTempPage (slot);
+}
 
-	// check if we are extending the size of the temp file
-	size_t pos;
-	if (availablePositions.size () == 0) {
-		pos = lastTempPos++;
-	} else {
-		pos = availablePositions.top ();
-		availablePositions.pop ();
+size_t MyDB_BufferManager :: reserveTempPages (size_t numPages) {
+	lock_guard <mutex> guard (tempLock);
+	size_t first = tempSpace.allocate (numPages);
+	checkTempGrowth ();
+	return first;
+}
+
+void MyDB_BufferManager :: checkTempGrowth () {
+	if (tempSpace.getEnd () <= tempFileSize)
+		return;
+	tempFileGrowth += tempSpace.getEnd () - tempFileSize;
+	tempFileSize = tempSpace.getEnd ();
+	maxTempFileSize = max (maxTempFileSize, tempFileSize);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPage (size_t reservedSlot) {
+	return makeTempPage (reservedSlot);
+}
+
+void MyDB_BufferManager :: releaseTempPages (size_t firstSlot, size_t numPages) {
+	releaseTempSlots (firstSlot, numPages);
+}
+
+size_t MyDB_BufferManager :: getTempFileSize () {
+	lock_guard <mutex> guard (tempLock);
+	return tempFileSize;
+}
+
+size_t MyDB_BufferManager :: getNumFreeTempSlots () {
+	lock_guard <mutex> guard (tempLock);
+	return tempSpace.getNumFree ();
+}
+
+MyDB_BufferManager :: FileInfo MyDB_BufferManager :: getTempFile () {
+	lock_guard <mutex> guard (tableLock);
+	if (files[0].fd == -1) {
+		files[0].fd = openFile (tempFile, O_TRUNC | O_CREAT | O_RDWR);
 	}
+	return files[0];
+}
 
-	MyDB_PagePtr returnVal = make_shared <MyDB_Page> (nullptr, pos, *this);
-	return make_shared <MyDB_PageHandleBase> (returnVal);
+MyDB_PageHandle MyDB_BufferManager :: makeTempPage (size_t slot) {
+	MyDB_PagePtr returnVal = make_shared <MyDB_Page> (nullptr, slot, *this);
+	FileInfo file = getTempFile ();
+	returnVal->fd = file.fd;
+	returnVal->counters = file.counters;
+	returnVal->shard = shardFor (0, slot);
+	returnVal->pool = tempPool;
+	traceEvent (MyDB_TraceEventType :: NewTempPage, *returnVal);
+	return MyDB_PageHandle (returnVal);
 }
 
-void MyDB_BufferManager :: kickOutPage () {
-	
-	// find the oldest page
-	auto it = lastUsed.begin();
-	auto page = *it;
+void MyDB_BufferManager :: releaseTempSlots (size_t firstSlot, size_t numSlots) {
 
-	if (lastUsed.size () == 0)
-		cout << "Bad: all buffer memory is exhausted!";
+	// this is done with the lock held, so that nobody can get one of the slots and write to
+	// it before its space is given back
+	lock_guard <mutex> guard (tempLock);
+	tempSpace.release (firstSlot, numSlots);
+
+	// if there is a good chunk free at the end of the file, cut it off... but not every
+	// time a page at the end goes away, since the next one will probably just grow it again
+	size_t end = tempSpace.getEnd ();
+	if (tempFileSize >= end + TEMP_TRUNCATE_SLOTS || (end == 0 && tempFileSize > 0)) {
+		if (ftruncate (files[0].fd, end * pageSize) == 0)
+			tempFileSize = end;
+	}
+
+	// and every so often, give back the space of big free extents in the middle of the file
+	if (tempSpace.getNumReleased () < TEMP_HOLE_SLOTS)
+		return;
+	for (auto &hole : tempSpace.takeHoles (TEMP_HOLE_SLOTS)) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+		fallocate (files[0].fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, hole.first * pageSize,
+			hole.second * pageSize);
+#endif
+	}
+}
+
+bool MyDB_BufferManager :: kickOutPage (Shard &shard, unique_lock <mutex> &guard, size_t forPool) {
+
+	// find the page to get rid of... if there is none, maybe some pages are just waiting
+	// for their reads to be done
+	long victim = chooseVictim (shard, forPool);
+	while (victim == -1 && (shard.pendingReads.size () > 0 || shard.numLoading > 0)) {
+		if (shard.pendingReads.size () > 0)
+			reapReads (shard, true);
+		else
+			shard.loaded.wait (guard);
+
+		// somebody else may have freed up a frame while we were waiting
+		if (shard.availableFrames.size () > 0)
+			return true;
+		victim = chooseVictim (shard, forPool);
+	}
+	if (victim == -1)
+		return false;
+	evictPage (shard, frameOwners[victim + shard.firstFrame]);
+	return true;
+}
+
+void MyDB_BufferManager :: evictPage (Shard &shard, MyDB_PagePtr page) {
 
 	// make sure we don't have a null pointer
-	if (page->bytes == nullptr) {
+	if (page == nullptr || page->bytes == nullptr) {
 		cout << "Bad!! Kicking out a page with no RAM.";
 		exit (1);
 	}
 
-	// write it back if necessary
-	if (page->isDirty) {
-		lseek (fds[page->myTable], page->pos * pageSize, SEEK_SET);
-		write (fds[page->myTable], page->bytes, pageSize);
+	page->counters->numEvictions++;
+	traceEvent (MyDB_TraceEventType :: Evict, *page);
+
+	// write it back if necessary (waiting first for the flusher, if it is writing him)...
+	// unless nobody is ever going to read it
+	finishWrite (page);
+	if (page->isDirty && isDead (page)) {
 		page->isDirty = false;
+		shard.numAvoidedWrites++;
+	} else if (page->isDirty) {
+		vector <MyDB_PagePtr> writeMe (1, page);
+		writeBack (writeMe, false);
+		shard.numEvictionWrites++;
 	}
 
-	// remove it
-	lastUsed.erase (page);
-
 	// remember its RAM
-	availableRam.push_back (page->bytes);
-	page->bytes = nullptr;
+	releaseFrame (shard, page);
 
 	// if this guy has no references, kill him
-	if (page->refCount == 0)
-		killPage (page);
+	if (page->refCount == 0) {
+		killPage (shard, page);
+		page->me = nullptr;
+	}
+}
+
+long MyDB_BufferManager :: chooseVictim (Shard &shard, size_t forPool) {
+
+	// a pool at its maximum has to make room by itself
+	Pool &pool = *pools[forPool];
+	if (pool.numFrames >= pool.maxFrames) {
+		long victim = shard.policies[forPool]->victim ();
+		if (victim != -1)
+			return victim;
+	}
+
+	// otherwise, try the pools that can spare a frame (and the pool itself), the one that
+	// has gone longest without an access first... there are only a handful of pools, so
+	// each one is just inserted into place
+	size_t candidates[MAX_BUFFER_POOLS];
+	size_t numCandidates = 0;
+	for (size_t p = 0; p < pools.size () && p < MAX_BUFFER_POOLS; p++) {
+		if (p != forPool && pools[p]->numFrames <= pools[p]->minFrames)
+			continue;
+		size_t i = numCandidates++;
+		for (; i > 0 && shard.lastUse[candidates[i - 1]] > shard.lastUse[p]; i--)
+			candidates[i] = candidates[i - 1];
+		candidates[i] = p;
+	}
+	for (size_t i = 0; i < numCandidates; i++) {
+		long victim = shard.policies[candidates[i]]->victim ();
+		if (victim != -1)
+			return victim;
+	}
+	return -1;
+}
+
+void MyDB_BufferManager :: findColdFrames (Shard &shard, size_t num) {
+	shard.coldFrames.clear ();
+	for (auto &policy : shard.policies)
+		policy->coldest (num, shard.coldFrames);
+}
+
+long MyDB_BufferManager :: getFrame (Shard &shard, unique_lock <mutex> &guard, size_t forPool) {
+
+	// a pool at its maximum evicts one of its own pages even if there are free frames... as
+	// long as it has one in this shard that can be evicted
+	Pool &pool = *pools[forPool];
+	if (shard.availableFrames.size () > 0 && pool.numFrames >= pool.maxFrames) {
+		shard.coldFrames.clear ();
+		shard.policies[forPool]->coldest (1, shard.coldFrames);
+		if (shard.coldFrames.size () > 0)
+			kickOutPage (shard, guard, forPool);
+	}
+
+	// see if there is space... evicting a page from a retired frame does not make any, so
+	// this keeps going until there is a frame or nothing left to evict
+	while (shard.availableFrames.size () == 0) {
+		reapReads (shard, false);
+		if (!kickOutPage (shard, guard, forPool))
+			break;
+
+		// every so often, have the flusher clean the frames that are next in line
+		if (shard.numToClean > 0 && ++shard.evictionsSinceClean >= (shard.numToClean + 1) / 2) {
+			shard.evictionsSinceClean = 0;
+			cleanColdFrames (shard);
+		}
+	}
+
+	// if there is no space, we cannot do anything
+	if (shard.availableFrames.size () == 0)
+		return -1;
+
+	size_t whichFrame = shard.availableFrames.back ();
+	shard.availableFrames.pop_back ();
+	return whichFrame;
 }
 
-void MyDB_BufferManager :: killPage (MyDB_PagePtr killMe) {
-	
+long MyDB_BufferManager :: waitForFrame (Shard &shard, unique_lock <mutex> &guard, size_t forPool) {
+	long whichFrame = getFrame (shard, guard, forPool);
+	if (whichFrame != -1 || frameWaitMillis == 0)
+		return whichFrame;
+
+	// every frame is pinned... wait for somebody else to unpin one
+	auto deadline = chrono :: steady_clock :: now () + chrono :: milliseconds (frameWaitMillis);
+	shard.numFrameWaiters++;
+	while (whichFrame == -1) {
+		bool timedOut = (shard.loaded.wait_until (guard, deadline) == cv_status :: timeout);
+		whichFrame = getFrame (shard, guard, forPool);
+		if (timedOut)
+			break;
+	}
+	shard.numFrameWaiters--;
+	return whichFrame;
+}
+
+void MyDB_BufferManager :: assignFrame (MyDB_PagePtr putHere, size_t whichFrame) {
+	frameOwners[whichFrame] = putHere;
+	pools[putHere->pool]->numFrames++;
+	putHere->bytes = frameArena->getFrame (whichFrame);
+	putHere->numBytes = pageSize;
+	putHere->frame = whichFrame;
+}
+
+void MyDB_BufferManager :: freeFrame (Shard &shard, size_t whichFrame) {
+	if (isRetired (shard, whichFrame))
+		frameArena->discard (whichFrame, 1);
+	else
+		shard.availableFrames.push_back (whichFrame);
+}
+
+void MyDB_BufferManager :: checkRetired (Shard &shard, MyDB_PagePtr page) {
+	if (page->bytes != nullptr && !page->mapped && page->pinCount == 0 && !page->loading &&
+		page->readTicket == -1 && isRetired (shard, page->frame)) {
+		policyFor (shard, *page)->remove (page->frame - shard.firstFrame);
+		evictPage (shard, page);
+	}
+}
+
+void MyDB_BufferManager :: releaseFrame (Shard &shard, MyDB_PagePtr takeMe) {
+	finishWrite (takeMe);
+	freeFrame (shard, takeMe->frame);
+	frameOwners[takeMe->frame] = nullptr;
+	pools[takeMe->pool]->numFrames--;
+	takeMe->bytes = nullptr;
+	takeMe->frame = -1;
+	frameFreed (shard);
+	if (takeMe->pinCount > 0) {
+		traceEvent (MyDB_TraceEventType :: Unpin, *takeMe);
+		takeMe->pinCount = 0;
+		unpinnedFrame (shard);
+	}
+}
+
+void MyDB_BufferManager :: killPage (MyDB_Page *killMe) {
+
+	// somebody may have gotten a new handle to the page before we got the lock
+	Shard &shard = *shards[killMe->shard];
+	lock_guard <mutex> guard (shard.lock);
+	if (--killMe->refCount == 0 && killMe->me != nullptr) {
+		MyDB_PagePtr page = move (killMe->me);
+		killPage (shard, page);
+	}
+}
+
+void MyDB_BufferManager :: killPage (Shard &shard, MyDB_PagePtr killMe) {
 
 	// if this is an anon page...
 	if (killMe->myTable == nullptr) {
 
-		// recycle him
-		availablePositions.push (killMe->pos);
+		// if he has RAM, take it away (and get him out of the replacement policy)... this waits
+		// for any write of the page, so it is done before his slot can be truncated away
 		if (killMe->bytes != nullptr) {
-			availableRam.push_back (killMe->bytes);
+			policyFor (shard, *killMe)->remove (killMe->frame - shard.firstFrame);
+			releaseFrame (shard, killMe);
 		}
 
-		// if he is in the LRU list, remove him
-		if (lastUsed.count (killMe) != 0) {
-			auto page = *(lastUsed.find (killMe));
-			lastUsed.erase (page);
-		}
+		// and recycle him
+		traceEvent (MyDB_TraceEventType :: KillTempPage, *killMe);
+		releaseTempSlots (killMe->pos, 1);
 
 	// if this is a pinned, non-anon page whose data is buffered it converts...
-	} else if (lastUsed.count (killMe) == 0 && killMe->bytes != nullptr) {
-		killMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (killMe);
+	} else if (killMe->bytes != nullptr && !killMe->mapped) {
+		if (killMe->pinCount > 0 && !killMe->loading && killMe->readTicket == -1) {
+			traceEvent (MyDB_TraceEventType :: Unpin, *killMe);
+			killMe->pinCount = 0;
+			unpinnedFrame (shard);
+			makeEvictable (shard, killMe);
+			checkRetired (shard, killMe);
+		}
 
-	// this guy has no data, so just kill him
-	} else if (killMe->bytes == nullptr) {
-		pair <MyDB_TablePtr, long> whichPage = make_pair (killMe->myTable, killMe->pos);
-		allPages.erase (whichPage);
+	// this guy has no data (or just points into a mapped file), so just kill him... unless
+	// the page table has already moved on to a newer page object for the same page
+	} else {
+		uint64_t whichPage = pageKey (killMe->slot, killMe->pos);
+		MyDB_PagePtr *found = shard.pages.find (whichPage);
+		if (found != nullptr && *found == killMe)
+			shard.pages.remove (whichPage);
 	}
 }
 
-void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
-	
-	// if this page was just accessed, get outta here
-	if (updateMe->timeTick > lastTimeTick - (numPages / 2) && updateMe->bytes != nullptr) {
-		return;
-	}
+bool MyDB_BufferManager :: isDead (MyDB_PagePtr page) {
+	return page->myTable == nullptr && (page->refCount == 0 || page->discardable);
+}
 
-	// first, see if it is currently in the LRU list; if it is, update it
-	if (lastUsed.count (updateMe) == 1) {
-		auto page = *(lastUsed.find (updateMe));
-		lastUsed.erase (page);
-		updateMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (updateMe);
-
-	// here, we don't have the bytes...
-	} else if (updateMe->bytes == nullptr) {
-		
-		// not in the LRU list means that we don't have its contents buffered
-		// see if there is space
-		if (availableRam.size () == 0)
-			kickOutPage ();
-
-		// if there is no space, we cannot do anything
-		if (availableRam.size () == 0) {
-			cout << "Can't get any RAM to read a page!!\n";
-			exit (1);
+void MyDB_BufferManager :: pinnedFrame (Shard &shard) {
+	shard.numPinned++;
+	size_t nowPinned = ++numPinnedFrames;
+	size_t oldMax = maxPinnedFrames;
+	while (nowPinned > oldMax && !maxPinnedFrames.compare_exchange_weak (oldMax, nowPinned));
+}
+
+void MyDB_BufferManager :: unpinnedFrame (Shard &shard) {
+	shard.numPinned--;
+	numPinnedFrames--;
+}
+
+void MyDB_BufferManager :: makeEvictable (Shard &shard, MyDB_PagePtr page) {
+	policyFor (shard, *page)->add (page->frame - shard.firstFrame, pageKey (page->slot, page->pos));
+	if (page->scanned)
+		scannedPage (shard, page);
+	frameFreed (shard);
+}
+
+bool MyDB_BufferManager :: bringIn (Shard &shard, unique_lock <mutex> &guard, MyDB_PagePtr bringMe, bool pinIt) {
+
+	// a page of a mapped table is always there, and never needs to be pinned
+	if (bringMe->mapped)
+		return true;
+
+	long whichFrame;
+	while (true) {
+
+		// if somebody else is reading the page in, wait for him
+		while (bringMe->loading)
+			shard.loaded.wait (guard);
+
+		// if the page is buffered, just let the replacement policy know about the access
+		shard.lastUse[bringMe->pool] = ++shard.tick;
+		if (bringMe->bytes != nullptr) {
+			bringMe->counters->numHits++;
+			traceEvent (MyDB_TraceEventType :: Hit, *bringMe);
+			if (bringMe->readTicket != -1)
+				finishRead (shard, bringMe);
+
+			// a pinned page is taken out of the replacement policy
+			if (pinIt) {
+				traceEvent (MyDB_TraceEventType :: Pin, *bringMe);
+				bringMe->readAhead = false;
+				if (bringMe->pinCount++ == 0) {
+					policyFor (shard, *bringMe)->pin (bringMe->frame - shard.firstFrame);
+					pinnedFrame (shard);
+				}
+				return true;
+			}
+
+			if (bringMe->pinCount == 0)
+				policyFor (shard, *bringMe)->touch (bringMe->frame - shard.firstFrame);
+
+			// the first access to a prefetched page is the one that counts for a scan
+			if (bringMe->readAhead) {
+				bringMe->readAhead = false;
+				if (bringMe->scanned && bringMe->pinCount == 0)
+					scannedPage (shard, bringMe);
+			}
+			return true;
 		}
 
-		// get some RAM for the page
-		updateMe->bytes = availableRam[availableRam.size () - 1]; 
-		updateMe->numBytes = pageSize;
-		availableRam.pop_back ();
+		// here, we don't have the bytes... so get some RAM for the page
+		whichFrame = waitForFrame (shard, guard, bringMe->pool);
+		if (whichFrame == -1)
+			return false;
 
-		// and read it
-		lseek (fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
-		read (fds[updateMe->myTable], updateMe->bytes, pageSize);
+		// waitForFrame may have unlocked the shard, in which case somebody else may have
+		// started reading the page in; if so, give the frame back and start over
+		if (bringMe->bytes != nullptr || bringMe->loading) {
+			freeFrame (shard, whichFrame);
+			continue;
+		}
+		break;
+	}
 
-		updateMe->timeTick = ++lastTimeTick;
-		lastUsed.insert (updateMe);
+	bringMe->counters->numMisses++;
+	traceEvent (MyDB_TraceEventType :: Miss, *bringMe);
+	assignFrame (bringMe, whichFrame);
+
+	// and read it, without the shard locked... nobody else touches the page until loading is
+	// cleared, and it is not in the replacement policy, so the frame cannot go away
+	bringMe->loading = true;
+	shard.numLoading++;
+	if (pinIt) {
+		traceEvent (MyDB_TraceEventType :: Pin, *bringMe);
+		bringMe->pinCount++;
+		pinnedFrame (shard);
 	}
+	guard.unlock ();
+	readPage (bringMe);
+	guard.lock ();
+	bringMe->loading = false;
+	shard.numLoading--;
+	shard.loaded.notify_all ();
+
+	if (bringMe->pinCount == 0)
+		makeEvictable (shard, bringMe);
+	return true;
 }
 
-MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
+bool MyDB_BufferManager :: access (const MyDB_PagePtr &updateMe) {
+
+	// a pinned page cannot go anywhere, and is not in the replacement policy, so there is
+	// nothing to lock... this is what makes a scan over pinned pages cheap.  Neither can a
+	// page of a mapped table
+	Shard &shard = *shards[updateMe->shard];
+	if (updateMe->mapped)
+		return true;
+	if (updateMe->pinCount > 0 && !updateMe->loading) {
+		updateMe->counters->numHits++;
+		traceEvent (MyDB_TraceEventType :: Hit, *updateMe);
+		return true;
+	}
 
-	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
+	// otherwise, read the page in if need be, and let the replacement policy know about the access
+	unique_lock <mutex> guard (shard.lock);
+	return bringIn (shard, guard, updateMe, false);
+}
+
+void MyDB_BufferManager :: scannedPage (Shard &shard, MyDB_PagePtr scanMe) {
+
+	// a scan is done with a page once it has read a couple more... the page that a
+	// scan is on is never demoted, since the caller may still hold pointers into it
+	shard.recentScanFrames.push_back (make_pair ((size_t) scanMe->frame, pageKey (scanMe->slot, scanMe->pos)));
+	if (shard.recentScanFrames.size () > NUM_CURRENT_SCAN_PAGES) {
+		size_t oldFrame = shard.recentScanFrames.front ().first;
+		MyDB_PagePtr oldPage = frameOwners[oldFrame];
+		if (oldPage != nullptr && oldPage->scanned && oldPage->pinCount == 0 && oldPage->readTicket == -1 &&
+			!oldPage->loading && pageKey (oldPage->slot, oldPage->pos) == shard.recentScanFrames.front ().second)
+			policyFor (shard, *oldPage)->demote (oldFrame - shard.firstFrame);
+		shard.recentScanFrames.pop_front ();
 	}
+}
+
+bool MyDB_BufferManager :: pin (const MyDB_PagePtr &pinMe) {
+	Shard &shard = *shards[pinMe->shard];
+	unique_lock <mutex> guard (shard.lock);
+	return bringIn (shard, guard, pinMe, true);
+}
+
+MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
 
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
@@ -197,80 +1257,101 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, l
 		exit (1);
 	}
 
+	// open the file, if it is not open
+	FileInfo file;
+	size_t slot = getSlot (whichTable, file);
+
 	// first, see if the page is there in the buffer
-	pair <MyDB_TablePtr, long> whichPage = make_pair (whichTable, i);
-	MyDB_PagePtr returnVal;
+	Shard &shard = *shards[shardFor (slot, i)];
+	unique_lock <mutex> guard (shard.lock);
+	MyDB_PagePtr *found = shard.pages.find (pageKey (slot, i));
+	MyDB_PageHandle returnVal;
 
 	// see if we already know him
-	if (allPages.count (whichPage) == 0) {
+	if (found == nullptr) {
 
 		// in this case, we do not
-		returnVal = make_shared <MyDB_Page> (whichTable, i, *this);
-		allPages [whichPage] = returnVal;
+		returnVal = MyDB_PageHandle (makePage (whichTable, i, slot, file));
 
 	// in this case, we do
 	} else {
-
-		// get him out of the LRU list if he is there
-		returnVal = allPages [whichPage];
-		if (lastUsed.count (returnVal) != 0) {
-			auto page = *(lastUsed.find (returnVal));
-	       		lastUsed.erase (page);
-		}
+		returnVal = MyDB_PageHandle (*found);
 	}
 
-	// see if we need to get his data
-	if (returnVal->bytes == nullptr) {
-
-		// see if there is space to make a pinned page
-		if (availableRam.size () == 0)
-			kickOutPage ();
-
-		// if there is no space, we cannot do anything
-		if (availableRam.size () == 0) 
-			return nullptr;
+	// a pinned page is not a scan page
+	returnVal.page->scanned = false;
 
-		// set up the return val
-		returnVal->bytes = availableRam[availableRam.size () - 1];
-		returnVal->numBytes = pageSize;
-		availableRam.pop_back ();
-
-		// and read it
-		lseek (fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
-		read (fds[returnVal->myTable], returnVal->bytes, pageSize);
-
-	}	
+	// if there is no space, we cannot do anything... the shard is unlocked before the
+	// handle goes away, since killing the page locks it again
+	if (!bringIn (shard, guard, returnVal.page->me, true)) {
+		guard.unlock ();
+		return nullptr;
+	}
 
 	// get outta here
-	return make_shared <MyDB_PageHandleBase> (returnVal);
+	return returnVal;
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
 
+	// get a page to return... a temp page is never looked up by position, so it can go in any
+	// shard; put it in the one with the fewest pinned pages, so that a big sort does not fill
+	// one shard up with pinned pages while there is room in the others
+	MyDB_PageHandle returnVal = getPage ();
+	for (size_t s = 0; s < shards.size (); s++) {
+		if (shards[s]->numPinned < shards[returnVal.page->shard]->numPinned)
+			returnVal.page->shard = s;
+	}
+	Shard &shard = *shards[returnVal.page->shard];
+	unique_lock <mutex> guard (shard.lock);
+
 	// see if there is space to make a pinned page
-	if (availableRam.size () == 0)
-		kickOutPage ();
+	long whichFrame = waitForFrame (shard, guard, returnVal.page->pool);
 
 	// if there is no space, we cannot do anything
-	if (availableRam.size () == 0) 
+	if (whichFrame == -1) {
+		guard.unlock ();
 		return nullptr;
+	}
 
-	// get a page to return
-	MyDB_PageHandle returnVal = getPage ();
-	returnVal->page->bytes = availableRam[availableRam.size () - 1];
-	returnVal->page->numBytes = pageSize;
-	availableRam.pop_back ();
+	assignFrame (returnVal.page->me, whichFrame);
+	returnVal.page->pinCount = 1;
+	pinnedFrame (shard);
+	traceEvent (MyDB_TraceEventType :: Pin, *returnVal.page);
 
 	// and get outta here
 	return returnVal;
 }
 
-void MyDB_BufferManager :: unpin (MyDB_PagePtr unpinMe) {
-	unpinMe->timeTick = ++lastTimeTick;
-	lastUsed.insert (unpinMe);
+void MyDB_BufferManager :: unpin (const MyDB_PagePtr &unpinMe) {
+
+	// the common case, where the page is not pinned, needs no lock
+	if (unpinMe->pinCount == 0)
+		return;
+
+	Shard &shard = *shards[unpinMe->shard];
+	lock_guard <mutex> guard (shard.lock);
+	if (unpinMe->bytes == nullptr || unpinMe->pinCount == 0)
+		return;
+	traceEvent (MyDB_TraceEventType :: Unpin, *unpinMe);
+	if (--unpinMe->pinCount > 0)
+		return;
+
+	// if the page is still being read, it is made evictable once the read is done
+	unpinnedFrame (shard);
+	if (!unpinMe->loading && unpinMe->readTicket == -1) {
+
+		// a scan is done with its page once it lets go of it
+		policyFor (shard, *unpinMe)->add (unpinMe->frame - shard.firstFrame, pageKey (unpinMe->slot, unpinMe->pos));
+		if (unpinMe->scanned)
+			policyFor (shard, *unpinMe)->demote (unpinMe->frame - shard.firstFrame);
+		frameFreed (shard);
+		checkRetired (shard, unpinMe);
+	}
 }
 
-MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn) {
+MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn, string tempFileIn,
+	MyDB_ReplacementType replacementIn, bool directIOIn, size_t maxPagesIn) {
 
 	// remember the inputs
 	pageSize = pageSizeIn;
@@ -278,46 +1359,128 @@ MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn,
 	// this is the location where we write temp pages
 	tempFile = tempFileIn;
 
-	// start at time tick zero
-	lastTimeTick = 0;
+	// nothing is in the temp file yet
+	tempFileSize = 0;
+	maxTempFileSize = 0;
+	tempFileGrowth = 0;
 
-	// position in temp file
-	lastTempPos = 0;
-
-	// the number of pages
+	// the number of pages, and the most that there can be
 	numPages = numPagesIn;
+	maxPages = max (maxPagesIn, numPagesIn);
+	cleanFraction = DEFAULT_CLEAN_FRACTION;
+
+	// slot 0 is the temp file, which is opened the first time it is needed
+	files.push_back (FileInfo ());
+	slotTables.push_back (nullptr);
+	tableCounters.push_back (unique_ptr <MyDB_TableCounters> (new MyDB_TableCounters));
+	files[0].counters = tableCounters[0].get ();
+
+	// nothing is pinned or traced yet
+	numPinnedFrames = 0;
+	maxPinnedFrames = 0;
+	tracing = false;
+
+	// everything starts out in the default pool, which can have the whole buffer
+	replacement = replacementIn;
+	pools.push_back (unique_ptr <Pool> (new Pool));
+	pools[0]->name = "default";
+	pools[0]->minFrames = 0;
+	pools[0]->maxFrames = maxPages;
+	pools[0]->numFrames = 0;
+	tempPool = 0;
+
+	// nothing is reserved yet
+	numReservedFrames = 0;
+	frameWaitMillis = FRAME_WAIT_MILLIS;
+
+	// create all of the RAM, in one piece, with room to grow
+	frameArena = MyDB_FrameArenaPtr (new MyDB_FrameArena (pageSizeIn, maxPages));
+	frameOwners.resize (maxPages, nullptr);
+
+	// pages are not checksummed unless asked for
+	pageChecksums = false;
+
+	// direct I/O needs the frames, and the offsets in the files, to be aligned
+	directIO = directIOIn && pageSize % FRAME_ALIGNMENT == 0 && frameArena->isPageAligned ();
+
+	// use as many shards as we can (a power of two), while giving each enough frames
+	// that a handful of pinned pages cannot use up a shard
+	size_t numShards = 1;
+	while (numShards < MAX_BUFFER_SHARDS && numPages / (numShards * 2) >= MIN_FRAMES_PER_SHARD)
+		numShards *= 2;
+
+	// and split the frames between them... each shard gets its share of the room to grow,
+	// and starts out using its share of numPages
+	size_t total = 0;
+	for (size_t s = 0; s < numShards; s++) {
+		unique_ptr <Shard> shard (new Shard);
+		shard->firstFrame = s * maxPages / numShards;
+		shard->numFrames = (s + 1) * maxPages / numShards - shard->firstFrame;
+		shard->policies.push_back (MyDB_ReplacementPolicy :: create (replacement, shard->numFrames));
+		shard->tick = 0;
+		shard->lastUse.push_back (0);
+		setNumActive (*shard, min (shard->numFrames, (s + 1) * numPages / numShards - s * numPages / numShards));
+		total += shard->numActive;
+
+		// hand out the low frames first
+		for (size_t i = shard->numActive; i > 0; i--) {
+			shard->availableFrames.push_back (shard->firstFrame + i - 1);
+		}
 
-	// create all of the RAM
-	for (size_t i = 0; i < numPages; i++) {
-		availableRam.push_back (malloc (pageSizeIn));
-	}	
+		shard->numLoading = 0;
+		shard->numPinned = 0;
+		shard->numFrameWaiters = 0;
+
+		// nothing has been written yet
+		shard->numEvictionWrites = 0;
+		shard->numBackgroundWrites = 0;
+		shard->numAvoidedWrites = 0;
+		shards.push_back (move (shard));
+	}
+
+	numPages = total;
+	setCleanFraction (DEFAULT_CLEAN_FRACTION);
 }
 
 MyDB_BufferManager :: ~MyDB_BufferManager () {
-	
-	for (auto page : allPages) {
 
-		if (page.second->bytes != nullptr) {
-
-			// write it back if necessary
-			if (page.second->isDirty) {
-				lseek (fds[page.second->myTable], page.second->pos * pageSize, SEEK_SET);
-				write (fds[page.second->myTable], page.second->bytes, pageSize);
-			}
+	// nobody else can be using the buffer manager now, so there is no locking here...
+	// let any background reads and writes finish before the RAM goes away
+	if (ioThread != nullptr) {
+		for (auto &shard : shards)
+			reapReads (*shard, true);
+		ioThread->drain ();
+		checkBackgroundIO ();
+		ioThread = nullptr;
+	}
 
-			free (page.second->bytes);
-			page.second->bytes = nullptr;
-		}
+	// write back all of the dirty pages in one pass (temp pages are about to be deleted anyway)
+	vector <MyDB_PagePtr> writeMe;
+	for (auto &page : frameOwners) {
+		if (page != nullptr && page->isDirty && page->myTable != nullptr)
+			writeMe.push_back (page);
 	}
+	writeBack (writeMe, false);
+
+	for (auto &page : frameOwners) {
 
-	// delete the rest of the RAM
-	for (auto ram : availableRam) {
-		free (ram);
+		if (page == nullptr)
+			continue;
+
+		page->bytes = nullptr;
+		page->frame = -1;
+		page->writeTicket = -1;
 	}
 
-	// finally, close the files
-	for (auto fd : fds) {
-		close (fd.second);
+	// delete all of the RAM
+	frameArena = nullptr;
+
+	// finally, unmap and close the files
+	for (FileInfo &file : files) {
+		if (file.mapping != nullptr)
+			munmap (file.mapping, file.numMappedPages * pageSize);
+		if (file.fd != -1)
+			close (file.fd);
 	}
 
 	unlink (tempFile.c_str ());
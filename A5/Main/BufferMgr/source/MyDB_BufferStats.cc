@@ -0,0 +1,116 @@
+
+#ifndef BUFFER_STATS_C
+#define BUFFER_STATS_C
+
+#include "MyDB_BufferStats.h"
+
+// returns an upper bound on the p^th percentile of the histogram
+static size_t percentile (const size_t *histogram, double p) {
+	size_t total = 0;
+	for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++)
+		total += histogram[i];
+	if (total == 0)
+		return 0;
+
+	size_t soFar = 0;
+	for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+		soFar += histogram[i];
+		if (soFar >= p * total)
+			return ((size_t) 2) << i;
+	}
+	return ((size_t) 2) << (NUM_LATENCY_BUCKETS - 1);
+}
+
+void MyDB_TableStats :: add (const MyDB_TableStats &addMe) {
+	numHits += addMe.numHits;
+	numMisses += addMe.numMisses;
+	numPrefetches += addMe.numPrefetches;
+	numEvictions += addMe.numEvictions;
+	numWriteBacks += addMe.numWriteBacks;
+	bytesRead += addMe.bytesRead;
+	bytesWritten += addMe.bytesWritten;
+	for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+		readLatency[i] += addMe.readLatency[i];
+		writeLatency[i] += addMe.writeLatency[i];
+	}
+}
+
+double MyDB_TableStats :: hitRate () const {
+	if (numHits + numMisses == 0)
+		return 0;
+	return numHits / (double) (numHits + numMisses);
+}
+
+size_t MyDB_TableStats :: readPercentile (double p) const {
+	return percentile (readLatency, p);
+}
+
+size_t MyDB_TableStats :: writePercentile (double p) const {
+	return percentile (writeLatency, p);
+}
+
+size_t MyDB_TableStats :: bucketFor (double micros) {
+	size_t bucket = 0;
+	for (size_t limit = 2; bucket < NUM_LATENCY_BUCKETS - 1 && micros >= limit; limit *= 2)
+		bucket++;
+	return bucket;
+}
+
+// prints one line of the report
+static void printLine (ostream &toMe, const string &name, const MyDB_TableStats &stats) {
+	toMe << "  " << name << ": " << stats.numHits << " hits, " << stats.numMisses << " misses ("
+		<< stats.hitRate () * 100 << "% hits), " << stats.numPrefetches << " prefetched, "
+		<< stats.numEvictions << " evicted, " << stats.numWriteBacks << " written back; read "
+		<< stats.bytesRead << " bytes (p50 " << stats.readPercentile (0.5) << "us, p99 "
+		<< stats.readPercentile (0.99) << "us), wrote " << stats.bytesWritten << " bytes (p50 "
+		<< stats.writePercentile (0.5) << "us, p99 " << stats.writePercentile (0.99) << "us)\n";
+}
+
+void MyDB_BufferStats :: print (ostream &toMe) const {
+	toMe << "buffer: " << numFrames << " frames, " << numPinned << " pinned now, at most " << maxPinned
+		<< " pinned at once\n";
+	toMe << "temp file: " << tempFileSize << " pages now, at most " << maxTempFileSize << ", grew by "
+		<< tempFileGrowth << " pages in all\n";
+	toMe << "writes: " << numEvictionWrites << " on eviction, " << numBackgroundWrites << " by the flusher, "
+		<< numAvoidedWrites << " avoided\n";
+	for (auto &pool : byPool)
+		toMe << "pool " << pool.first << ": " << pool.second.numFrames << " frames (" << pool.second.minFrames
+			<< " to " << pool.second.maxFrames << ")\n";
+	printLine (toMe, "all tables", total);
+	for (auto &table : byTable)
+		printLine (toMe, table.first, table.second);
+}
+
+MyDB_TableCounters :: MyDB_TableCounters () : numHits (0), numMisses (0), numPrefetches (0), numEvictions (0),
+	numWriteBacks (0), bytesRead (0), bytesWritten (0) {
+	for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+		readLatency[i] = 0;
+		writeLatency[i] = 0;
+	}
+}
+
+void MyDB_TableCounters :: countRead (size_t numBytes, double micros) {
+	bytesRead += numBytes;
+	readLatency[MyDB_TableStats :: bucketFor (micros)]++;
+}
+
+void MyDB_TableCounters :: countWrite (size_t numBytes, double micros) {
+	bytesWritten += numBytes;
+	writeLatency[MyDB_TableStats :: bucketFor (micros)]++;
+}
+
+void MyDB_TableCounters :: snapshot (MyDB_TableStats &intoMe) {
+	intoMe.numHits = numHits;
+	intoMe.numMisses = numMisses;
+	intoMe.numPrefetches = numPrefetches;
+	intoMe.numEvictions = numEvictions;
+	intoMe.numWriteBacks = numWriteBacks;
+	intoMe.bytesRead = bytesRead;
+	intoMe.bytesWritten = bytesWritten;
+	for (size_t i = 0; i < NUM_LATENCY_BUCKETS; i++) {
+		intoMe.readLatency[i] = readLatency[i];
+		intoMe.writeLatency[i] = writeLatency[i];
+	}
+}
+
+#endif
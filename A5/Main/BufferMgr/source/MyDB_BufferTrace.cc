@@ -0,0 +1,93 @@
+
+#ifndef BUFFER_TRACE_C
+#define BUFFER_TRACE_C
+
+#include <cstring>
+#include <iostream>
+#include "MyDB_BufferTrace.h"
+#include "MyDB_FileIO.h"
+
+MyDB_TraceWriter :: MyDB_TraceWriter (string fName, size_t pageSize) {
+	file = fopen (fName.c_str (), "wb");
+	uint64_t header = pageSize;
+	if (file == nullptr || fwrite (TRACE_MAGIC, 1, 8, file) != 8 || fwrite (&header, sizeof (header), 1, file) != 1) {
+		cout << "Can't create the trace file " << fName << ": " << lastIOError () << "\n";
+		exit (1);
+	}
+	events.reserve (TRACE_BUFFER_EVENTS);
+	start = chrono :: steady_clock :: now ();
+}
+
+MyDB_TraceWriter :: ~MyDB_TraceWriter () {
+	lock_guard <mutex> guard (lock);
+	flush ();
+	fclose (file);
+}
+
+void MyDB_TraceWriter :: record (MyDB_TraceEventType type, size_t slot, size_t pos) {
+	uint64_t time = chrono :: duration_cast <chrono :: nanoseconds> (chrono :: steady_clock :: now () - start).count ();
+	lock_guard <mutex> guard (lock);
+	events.push_back (MyDB_TraceEvent {time, (uint32_t) type, (uint32_t) slot, pos});
+	if (events.size () == TRACE_BUFFER_EVENTS)
+		flush ();
+}
+
+void MyDB_TraceWriter :: nameSlot (size_t slot, string name) {
+	lock_guard <mutex> guard (lock);
+	uint64_t time = chrono :: duration_cast <chrono :: nanoseconds> (chrono :: steady_clock :: now () - start).count ();
+	events.push_back (MyDB_TraceEvent {time, (uint32_t) MyDB_TraceEventType :: SlotName, (uint32_t) slot, name.size ()});
+	flush ();
+	if (fwrite (name.data (), 1, name.size (), file) != name.size ()) {
+		cout << "Can't write to the trace file: " << lastIOError () << "\n";
+		exit (1);
+	}
+}
+
+void MyDB_TraceWriter :: flush () {
+	if (events.size () > 0 && fwrite (events.data (), sizeof (MyDB_TraceEvent), events.size (), file) != events.size ()) {
+		cout << "Can't write to the trace file: " << lastIOError () << "\n";
+		exit (1);
+	}
+	events.clear ();
+}
+
+MyDB_TraceReader :: MyDB_TraceReader (string fName) {
+	file = fopen (fName.c_str (), "rb");
+	char magic[8];
+	uint64_t header;
+	if (file == nullptr || fread (magic, 1, 8, file) != 8 || memcmp (magic, TRACE_MAGIC, 8) != 0 ||
+		fread (&header, sizeof (header), 1, file) != 1) {
+		cout << "Can't read the trace file " << fName << "\n";
+		exit (1);
+	}
+	pageSize = header;
+	slotNames[0] = "<temp>";
+}
+
+MyDB_TraceReader :: ~MyDB_TraceReader () {
+	fclose (file);
+}
+
+bool MyDB_TraceReader :: next (MyDB_TraceEvent &intoMe) {
+	while (fread (&intoMe, sizeof (intoMe), 1, file) == 1) {
+		if (intoMe.type != (uint32_t) MyDB_TraceEventType :: SlotName)
+			return true;
+
+		string name (intoMe.pos, ' ');
+		if (fread (&name[0], 1, intoMe.pos, file) != intoMe.pos)
+			return false;
+		slotNames[intoMe.slot] = name;
+	}
+	return false;
+}
+
+size_t MyDB_TraceReader :: getPageSize () {
+	return pageSize;
+}
+
+string MyDB_TraceReader :: getSlotName (size_t slot) {
+	auto found = slotNames.find (slot);
+	return found == slotNames.end () ? "" : found->second;
+}
+
+#endif
@@ -0,0 +1,226 @@
+
+#ifndef CHECKSUM_C
+#define CHECKSUM_C
+
+#include <cstring>
+#include "MyDB_Checksum.h"
+
+#if defined (__x86_64__)
+#include <nmmintrin.h>
+#elif defined (__aarch64__) && defined (__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+// the CRC32C polynomial, bit-reversed
+#define CRC32C_POLY 0x82F63B78
+
+// the hardware CRC is run on three blocks of LONG_BLOCK bytes at once, and then on three
+// blocks of SHORT_BLOCK bytes; both must be powers of two
+#define LONG_BLOCK 8192
+#define SHORT_BLOCK 256
+
+// the tables: slicing-by-8 tables for the software CRC, and tables that advance a CRC over
+// LONG_BLOCK and SHORT_BLOCK zero bytes, to stitch the three hardware streams back together
+struct CRCTables {
+	uint32_t bytes[8][256];
+	uint32_t longShift[4][256];
+	uint32_t shortShift[4][256];
+	bool hardware;
+	CRCTables ();
+};
+
+// multiplies the 32 x 32 GF(2) matrix mat by vec
+static uint32_t timesMatrix (const uint32_t *mat, uint32_t vec) {
+	uint32_t sum = 0;
+	for (; vec != 0; vec >>= 1, mat++) {
+		if (vec & 1)
+			sum ^= *mat;
+	}
+	return sum;
+}
+
+// square = mat * mat
+static void squareMatrix (uint32_t *square, const uint32_t *mat) {
+	for (int n = 0; n < 32; n++)
+		square[n] = timesMatrix (mat, mat[n]);
+}
+
+// fills shift with tables that advance a CRC over numBytes zero bytes (a power of two)
+static void makeShiftTables (uint32_t shift[4][256], size_t numBytes) {
+
+	// the operator for one zero bit, and then for two, four, eight...
+	uint32_t op[32], square[32];
+	op[0] = CRC32C_POLY;
+	for (int n = 1; n < 32; n++)
+		op[n] = 1U << (n - 1);
+	for (size_t numBits = 1; numBits < numBytes * 8; numBits *= 2) {
+		squareMatrix (square, op);
+		memcpy (op, square, sizeof (op));
+	}
+
+	// and then a table for each byte of the CRC
+	for (uint32_t n = 0; n < 256; n++) {
+		for (int b = 0; b < 4; b++)
+			shift[b][n] = timesMatrix (op, n << (8 * b));
+	}
+}
+
+CRCTables :: CRCTables () {
+	for (uint32_t n = 0; n < 256; n++) {
+		uint32_t crc = n;
+		for (int k = 0; k < 8; k++)
+			crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+		bytes[0][n] = crc;
+	}
+	for (uint32_t n = 0; n < 256; n++) {
+		for (int k = 1; k < 8; k++)
+			bytes[k][n] = (bytes[k - 1][n] >> 8) ^ bytes[0][bytes[k - 1][n] & 0xFF];
+	}
+	makeShiftTables (longShift, LONG_BLOCK);
+	makeShiftTables (shortShift, SHORT_BLOCK);
+
+#if defined (__x86_64__)
+	hardware = __builtin_cpu_supports ("sse4.2");
+#elif defined (__aarch64__) && defined (__ARM_FEATURE_CRC32)
+	hardware = true;
+#else
+	hardware = false;
+#endif
+}
+
+// the tables are built the first time that they are needed
+static const CRCTables &tables () {
+	static CRCTables theTables;
+	return theTables;
+}
+
+// advances crc over the zero bytes that a shift table was built for
+static inline uint32_t shiftCRC (const uint32_t shift[4][256], uint32_t crc) {
+	return shift[0][crc & 0xFF] ^ shift[1][(crc >> 8) & 0xFF] ^ shift[2][(crc >> 16) & 0xFF] ^ shift[3][crc >> 24];
+}
+
+uint32_t crc32cSoftware (uint32_t crc, const void *data, size_t numBytes) {
+	const uint32_t (*bytes)[256] = tables ().bytes;
+	const unsigned char *next = (const unsigned char *) data;
+	crc = ~crc;
+	while (numBytes > 0 && ((uintptr_t) next & 7) != 0) {
+		crc = (crc >> 8) ^ bytes[0][(crc ^ *next++) & 0xFF];
+		numBytes--;
+	}
+
+	// eight bytes at a time (this assumes a little-endian machine, as the rest of the system does)
+	for (; numBytes >= 8; numBytes -= 8, next += 8) {
+		uint64_t word;
+		memcpy (&word, next, 8);
+		word ^= crc;
+		crc = bytes[7][word & 0xFF] ^ bytes[6][(word >> 8) & 0xFF] ^ bytes[5][(word >> 16) & 0xFF] ^
+			bytes[4][(word >> 24) & 0xFF] ^ bytes[3][(word >> 32) & 0xFF] ^ bytes[2][(word >> 40) & 0xFF] ^
+			bytes[1][(word >> 48) & 0xFF] ^ bytes[0][word >> 56];
+	}
+	while (numBytes-- > 0)
+		crc = (crc >> 8) ^ bytes[0][(crc ^ *next++) & 0xFF];
+	return ~crc;
+}
+
+#if defined (__x86_64__) || (defined (__aarch64__) && defined (__ARM_FEATURE_CRC32))
+
+#if defined (__x86_64__)
+#define HARDWARE_CRC __attribute__ ((target ("sse4.2")))
+static inline HARDWARE_CRC uint32_t crcWord (uint32_t crc, const unsigned char *at) {
+	uint64_t word;
+	memcpy (&word, at, 8);
+	return (uint32_t) _mm_crc32_u64 (crc, word);
+}
+static inline HARDWARE_CRC uint32_t crcByte (uint32_t crc, unsigned char byte) {
+	return _mm_crc32_u8 (crc, byte);
+}
+#else
+#define HARDWARE_CRC
+static inline uint32_t crcWord (uint32_t crc, const unsigned char *at) {
+	uint64_t word;
+	memcpy (&word, at, 8);
+	return __crc32cd (crc, word);
+}
+static inline uint32_t crcByte (uint32_t crc, unsigned char byte) {
+	return __crc32cb (crc, byte);
+}
+#endif
+
+// runs the CRC over blocks of 3 * blockSize bytes, with each third done as its own stream
+static inline HARDWARE_CRC uint32_t crcBlocks (uint32_t crc, const unsigned char *&next, size_t &numBytes,
+	size_t blockSize, const uint32_t shift[4][256]) {
+
+	while (numBytes >= blockSize * 3) {
+		uint32_t crc1 = 0, crc2 = 0;
+		const unsigned char *end = next + blockSize;
+		do {
+			crc = crcWord (crc, next);
+			crc1 = crcWord (crc1, next + blockSize);
+			crc2 = crcWord (crc2, next + 2 * blockSize);
+			next += 8;
+		} while (next < end);
+		crc = shiftCRC (shift, crc) ^ crc1;
+		crc = shiftCRC (shift, crc) ^ crc2;
+		next += 2 * blockSize;
+		numBytes -= 3 * blockSize;
+	}
+	return crc;
+}
+
+static HARDWARE_CRC uint32_t crc32cHardware (uint32_t crc, const void *data, size_t numBytes) {
+	const CRCTables &theTables = tables ();
+	const unsigned char *next = (const unsigned char *) data;
+	crc = ~crc;
+	while (numBytes > 0 && ((uintptr_t) next & 7) != 0) {
+		crc = crcByte (crc, *next++);
+		numBytes--;
+	}
+	crc = crcBlocks (crc, next, numBytes, LONG_BLOCK, theTables.longShift);
+	crc = crcBlocks (crc, next, numBytes, SHORT_BLOCK, theTables.shortShift);
+	for (; numBytes >= 8; numBytes -= 8, next += 8)
+		crc = crcWord (crc, next);
+	while (numBytes-- > 0)
+		crc = crcByte (crc, *next++);
+	return ~crc;
+}
+
+#else
+
+static uint32_t crc32cHardware (uint32_t crc, const void *data, size_t numBytes) {
+	return crc32cSoftware (crc, data, numBytes);
+}
+
+#endif
+
+uint32_t crc32c (uint32_t crc, const void *data, size_t numBytes) {
+	static const bool hardware = tables ().hardware;
+	return hardware ? crc32cHardware (crc, data, numBytes) : crc32cSoftware (crc, data, numBytes);
+}
+
+bool hasHardwareCRC32C () {
+	return tables ().hardware;
+}
+
+uint32_t pageChecksum (const void *page, size_t pageSize) {
+	const char *bytes = (const char *) page;
+	uint32_t crc = crc32c (0, bytes, PAGE_CHECKSUM_OFFSET);
+	return crc32c (crc, bytes + PAGE_CHECKSUM_OFFSET + sizeof (uint32_t), pageSize - PAGE_CHECKSUM_OFFSET - sizeof (uint32_t));
+}
+
+uint32_t storedChecksum (const void *page) {
+	uint32_t checksum;
+	memcpy (&checksum, ((const char *) page) + PAGE_CHECKSUM_OFFSET, sizeof (uint32_t));
+	return checksum;
+}
+
+void setPageChecksum (void *page, size_t pageSize) {
+	uint32_t checksum = pageChecksum (page, pageSize);
+	memcpy (((char *) page) + PAGE_CHECKSUM_OFFSET, &checksum, sizeof (uint32_t));
+}
+
+bool pageChecksumOK (const void *page, size_t pageSize) {
+	uint32_t checksum = storedChecksum (page);
+	return checksum == 0 || checksum == pageChecksum (page, pageSize);
+}
+
+#endif
@@ -0,0 +1,77 @@
+
+#ifndef CLOCK_POLICY_C
+#define CLOCK_POLICY_C
+
+#include "MyDB_ClockPolicy.h"
+
+MyDB_ClockPolicy :: MyDB_ClockPolicy (size_t numFrames) : evictable (numFrames, 0), referenced (numFrames, 0) {
+	hand = 0;
+	numEvictable = 0;
+}
+
+void MyDB_ClockPolicy :: add (size_t whichFrame, uint64_t) {
+	if (evictable[whichFrame])
+		return;
+	evictable[whichFrame] = 1;
+	referenced[whichFrame] = 1;
+	numEvictable++;
+}
+
+void MyDB_ClockPolicy :: touch (size_t whichFrame) {
+	referenced[whichFrame] = 1;
+}
+
+void MyDB_ClockPolicy :: demote (size_t whichFrame) {
+	referenced[whichFrame] = 0;
+}
+
+void MyDB_ClockPolicy :: remove (size_t whichFrame) {
+	if (!evictable[whichFrame])
+		return;
+	evictable[whichFrame] = 0;
+	numEvictable--;
+}
+
+long MyDB_ClockPolicy :: victim () {
+
+	if (numEvictable == 0)
+		return -1;
+
+	// since there is at least one evictable frame, this ends within two sweeps
+	while (true) {
+		size_t whichFrame = hand;
+		hand = (hand + 1 == evictable.size ()) ? 0 : hand + 1;
+
+		if (!evictable[whichFrame])
+			continue;
+
+		// give him a second chance
+		if (referenced[whichFrame]) {
+			referenced[whichFrame] = 0;
+			continue;
+		}
+
+		remove (whichFrame);
+		return whichFrame;
+	}
+}
+
+void MyDB_ClockPolicy :: coldest (size_t num, vector <size_t> &coldFrames) {
+
+	// the frames without a second chance go first, in the order the hand gets to them;
+	// then, the ones that the hand will clear on its first sweep
+	for (int pass = 0; pass < 2; pass++) {
+		size_t whichFrame = hand;
+		for (size_t i = 0; i < evictable.size (); i++) {
+			if (num == 0)
+				return;
+			if (evictable[whichFrame] && referenced[whichFrame] == pass) {
+				coldFrames.push_back (whichFrame);
+				num--;
+			}
+			whichFrame = (whichFrame + 1 == evictable.size ()) ? 0 : whichFrame + 1;
+		}
+	}
+}
+
+#endif
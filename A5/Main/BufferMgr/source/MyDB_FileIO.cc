@@ -0,0 +1,140 @@
+
+#ifndef FILE_IO_C
+#define FILE_IO_C
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include "MyDB_FileIO.h"
+#include <unistd.h>
+
+// moves numBytes bytes past the start of the transfer, where first is the piece that the
+// transfer started at, and partial is what is left of that piece if an earlier transfer
+// stopped part way through it (or is empty).  Returns the index of the first piece that has
+// anything left, and sets partial to what is left of that piece if some of it was moved
+static int consume (const iovec *pieces, int numPieces, int first, iovec &partial, size_t numBytes) {
+
+	// a transfer into a partial piece only moves bytes of that piece
+	if (partial.iov_len > 0) {
+		partial.iov_base = ((char *) partial.iov_base) + numBytes;
+		partial.iov_len -= numBytes;
+		return partial.iov_len > 0 ? first : first + 1;
+	}
+
+	while (first < numPieces && numBytes >= pieces[first].iov_len) {
+		numBytes -= pieces[first].iov_len;
+		first++;
+	}
+	if (first < numPieces && numBytes > 0) {
+		partial.iov_base = ((char *) pieces[first].iov_base) + numBytes;
+		partial.iov_len = pieces[first].iov_len - numBytes;
+	}
+	return first;
+}
+
+// called when a transfer fails... if fd was opened with O_DIRECT and the failure was EINVAL,
+// then either the file system does not really do direct I/O, or this transfer is not aligned
+// (say, what is left of a page after a short read at the end of the file).  Either way, fd is
+// switched over to buffered I/O, and true is returned so that the transfer is retried
+static bool dropDirectIO (int fd) {
+#ifdef O_DIRECT
+	int error = errno;
+	int flags = fcntl (fd, F_GETFL);
+	if (error == EINVAL && flags != -1 && (flags & O_DIRECT) && fcntl (fd, F_SETFL, flags & ~O_DIRECT) != -1)
+		return true;
+	errno = error;
+#endif
+	return false;
+}
+
+bool readFully (int fd, const iovec *pieces, int numPieces, size_t offset) {
+
+	// the pieces are not ours to change, so after a short read, what is left of the piece
+	// that it stopped in is read by itself before going on to the rest
+	iovec partial = {nullptr, 0};
+	int first = 0;
+	while (first < numPieces) {
+		if (partial.iov_len == 0 && pieces[first].iov_len == 0) {
+			first++;
+			continue;
+		}
+
+		ssize_t numRead;
+		if (partial.iov_len > 0)
+			numRead = pread (fd, partial.iov_base, partial.iov_len, offset);
+		else
+			numRead = preadv (fd, pieces + first, numPieces - first, offset);
+		if (numRead == -1 && (errno == EINTR || dropDirectIO (fd)))
+			continue;
+		if (numRead == -1)
+			return false;
+
+		// we are at the end of the file, so the rest of the page has never been written
+		if (numRead == 0) {
+			if (partial.iov_len > 0) {
+				memset (partial.iov_base, 0, partial.iov_len);
+				first++;
+			}
+			for (; first < numPieces; first++)
+				memset (pieces[first].iov_base, 0, pieces[first].iov_len);
+			return true;
+		}
+
+		offset += numRead;
+		first = consume (pieces, numPieces, first, partial, numRead);
+	}
+	return true;
+}
+
+bool readFully (int fd, void *intoMe, size_t numBytes, size_t offset) {
+	iovec piece;
+	piece.iov_base = intoMe;
+	piece.iov_len = numBytes;
+	return readFully (fd, &piece, 1, offset);
+}
+
+bool writeFully (int fd, const iovec *pieces, int numPieces, size_t offset) {
+
+	// as in readFully, a short write is finished off one piece at a time
+	iovec partial = {nullptr, 0};
+	int first = 0;
+	while (first < numPieces) {
+		if (partial.iov_len == 0 && pieces[first].iov_len == 0) {
+			first++;
+			continue;
+		}
+
+		ssize_t numWritten;
+		if (partial.iov_len > 0)
+			numWritten = pwrite (fd, partial.iov_base, partial.iov_len, offset);
+		else
+			numWritten = pwritev (fd, pieces + first, numPieces - first, offset);
+		if (numWritten == -1 && (errno == EINTR || dropDirectIO (fd)))
+			continue;
+		if (numWritten == -1)
+			return false;
+
+		// there is something left to write, so writing nothing would just go on forever
+		if (numWritten == 0) {
+			errno = EIO;
+			return false;
+		}
+
+		offset += numWritten;
+		first = consume (pieces, numPieces, first, partial, numWritten);
+	}
+	return true;
+}
+
+bool writeFully (int fd, void *fromMe, size_t numBytes, size_t offset) {
+	iovec piece;
+	piece.iov_base = fromMe;
+	piece.iov_len = numBytes;
+	return writeFully (fd, &piece, 1, offset);
+}
+
+string lastIOError () {
+	return string (strerror (errno));
+}
+
+#endif
@@ -0,0 +1,102 @@
+
+#ifndef FRAME_ARENA_C
+#define FRAME_ARENA_C
+
+#include <cstdint>
+#include <iostream>
+#include "MyDB_FileIO.h"
+#include "MyDB_FrameArena.h"
+#include <sys/mman.h>
+
+// rounds numBytes up to a multiple of toMe
+static size_t roundUp (size_t numBytes, size_t toMe) {
+	return (numBytes + toMe - 1) / toMe * toMe;
+}
+
+// maps numBytes bytes of anonymous memory with the given extra flags; returns nullptr on failure
+static void *mapMemory (size_t numBytes, int flags) {
+	void *mem = mmap (nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+	return mem == MAP_FAILED ? nullptr : mem;
+}
+
+MyDB_FrameArena :: MyDB_FrameArena (size_t frameSize, size_t numFrames) {
+
+	// round the frames up, so that each one starts on an aligned boundary
+	size_t alignment = (frameSize % FRAME_ALIGNMENT == 0) ? FRAME_ALIGNMENT : CACHE_LINE_SIZE;
+	stride = roundUp (frameSize, alignment);
+	size_t numBytes = stride * numFrames;
+	if (numBytes == 0)
+		numBytes = stride;
+	reservedHugePages = false;
+
+	// a little arena just gets regular pages
+	if (numBytes < HUGE_PAGE_SIZE) {
+		mappingSize = roundUp (numBytes, FRAME_ALIGNMENT);
+		mapping = mapMemory (mappingSize, MAP_NORESERVE);
+
+	} else {
+
+		// first, try for reserved huge pages
+		mappingSize = roundUp (numBytes, HUGE_PAGE_SIZE);
+		mapping = nullptr;
+#ifdef MAP_HUGETLB
+		mapping = mapMemory (mappingSize, MAP_HUGETLB);
+		reservedHugePages = (mapping != nullptr);
+#endif
+
+		// if there are none, map an extra huge page's worth, so that the frames can start on
+		// a huge page boundary, and cut off the bits on either side... this memory is not
+		// counted against swap until it is touched, since a buffer that can grow may never
+		// use most of it
+		if (mapping == nullptr) {
+			char *raw = (char *) mapMemory (mappingSize + HUGE_PAGE_SIZE, MAP_NORESERVE);
+			if (raw != nullptr) {
+				char *aligned = (char *) roundUp ((uintptr_t) raw, HUGE_PAGE_SIZE);
+				if (aligned != raw)
+					munmap (raw, aligned - raw);
+				munmap (aligned + mappingSize, raw + HUGE_PAGE_SIZE - aligned);
+				mapping = aligned;
+
+				// and ask for the region to be backed by transparent huge pages
+#ifdef MADV_HUGEPAGE
+				madvise (mapping, mappingSize, MADV_HUGEPAGE);
+#endif
+			}
+		}
+	}
+
+	if (mapping == nullptr) {
+		cout << "Can't map " << mappingSize << " bytes of buffer memory: " << lastIOError () << "\n";
+		exit (1);
+	}
+	base = (char *) mapping;
+}
+
+MyDB_FrameArena :: ~MyDB_FrameArena () {
+	munmap (mapping, mappingSize);
+}
+
+void MyDB_FrameArena :: discard (size_t first, size_t num) {
+
+	// only whole pages can be given back (and with reserved huge pages, only whole huge
+	// pages), so the partial pages at either end are kept
+	size_t granule = reservedHugePages ? HUGE_PAGE_SIZE : FRAME_ALIGNMENT;
+	uintptr_t start = roundUp ((uintptr_t) getFrame (first), granule);
+	uintptr_t end = (uintptr_t) getFrame (first + num) / granule * granule;
+	if (end > start)
+		madvise ((void *) start, end - start, MADV_DONTNEED);
+}
+
+size_t MyDB_FrameArena :: getStride () {
+	return stride;
+}
+
+bool MyDB_FrameArena :: isPageAligned () {
+	return stride % FRAME_ALIGNMENT == 0;
+}
+
+bool MyDB_FrameArena :: usesReservedHugePages () {
+	return reservedHugePages;
+}
+
+#endif
@@ -0,0 +1,19 @@
+
+#ifndef FRAME_RESERVATION_C
+#define FRAME_RESERVATION_C
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_FrameReservation.h"
+
+MyDB_FrameReservation :: MyDB_FrameReservation (MyDB_BufferManager &parentIn, size_t numFramesIn) :
+	parent (parentIn), numFrames (numFramesIn) {}
+
+size_t MyDB_FrameReservation :: getNumFrames () {
+	return numFrames;
+}
+
+MyDB_FrameReservation :: ~MyDB_FrameReservation () {
+	parent.releaseFrames (numFrames);
+}
+
+#endif
@@ -0,0 +1,116 @@
+
+#ifndef IO_THREAD_C
+#define IO_THREAD_C
+
+#include <chrono>
+#include <cstdlib>
+#include "MyDB_FileIO.h"
+#include "MyDB_IOThread.h"
+
+MyDB_IOThread :: MyDB_IOThread () : numSubmitted (0), numCompleted (0), shuttingDown (false), hasFailed (false) {
+	worker = thread (&MyDB_IOThread :: run, this);
+}
+
+MyDB_IOThread :: ~MyDB_IOThread () {
+	{
+		unique_lock <mutex> guard (lock);
+		shuttingDown = true;
+	}
+	workToDo.notify_one ();
+	worker.join ();
+}
+
+size_t MyDB_IOThread :: read (int fd, size_t offset, void *intoMe, size_t numBytes, MyDB_TableCounters *countIn) {
+	iovec piece;
+	piece.iov_base = intoMe;
+	piece.iov_len = numBytes;
+	return submit (Request {false, fd, offset, vector <iovec> (1, piece), countIn, nullptr});
+}
+
+size_t MyDB_IOThread :: write (int fd, size_t offset, vector <iovec> pieces, MyDB_TableCounters *countIn,
+	void *freeMe) {
+	return submit (Request {true, fd, offset, std :: move (pieces), countIn, freeMe});
+}
+
+size_t MyDB_IOThread :: submit (Request doMe) {
+	size_t ticket;
+	{
+		unique_lock <mutex> guard (lock);
+		requests.push_back (std :: move (doMe));
+		ticket = numSubmitted++;
+	}
+	workToDo.notify_one ();
+	return ticket;
+}
+
+void MyDB_IOThread :: wait (size_t ticket) {
+	if (isDone (ticket))
+		return;
+	unique_lock <mutex> guard (lock);
+	workDone.wait (guard, [&] { return isDone (ticket); });
+}
+
+void MyDB_IOThread :: drain () {
+	size_t lastTicket;
+	{
+		unique_lock <mutex> guard (lock);
+		if (numSubmitted == 0)
+			return;
+		lastTicket = numSubmitted - 1;
+	}
+	wait (lastTicket);
+}
+
+string MyDB_IOThread :: getError () {
+	unique_lock <mutex> guard (lock);
+	return error;
+}
+
+void MyDB_IOThread :: run () {
+
+	while (true) {
+
+		// get the next request... we only quit once all of them are done
+		Request doMe;
+		{
+			unique_lock <mutex> guard (lock);
+			workToDo.wait (guard, [&] { return shuttingDown || requests.size () > 0; });
+			if (requests.size () == 0)
+				return;
+			doMe = std :: move (requests.front ());
+			requests.pop_front ();
+		}
+
+		// count the request before it is done, since once it is, the buffer manager
+		// (and the counters) may go away
+		size_t numBytes = 0;
+		for (iovec &piece : doMe.pieces)
+			numBytes += piece.iov_len;
+		auto start = chrono :: steady_clock :: now ();
+		bool ok;
+		if (doMe.isWrite)
+			ok = writeFully (doMe.fd, doMe.pieces.data (), (int) doMe.pieces.size (), doMe.offset);
+		else
+			ok = readFully (doMe.fd, doMe.pieces.data (), (int) doMe.pieces.size (), doMe.offset);
+		double micros = chrono :: duration <double, micro> (chrono :: steady_clock :: now () - start).count ();
+		if (doMe.countIn != nullptr && doMe.isWrite)
+			doMe.countIn->countWrite (numBytes, micros);
+		else if (doMe.countIn != nullptr)
+			doMe.countIn->countRead (numBytes, micros);
+		free (doMe.freeMe);
+
+		// and let everyone know... the lock makes sure that a waiter cannot miss this
+		{
+			unique_lock <mutex> guard (lock);
+			if (!ok && !hasFailed.load ()) {
+				error = string (doMe.isWrite ? "write" : "read") + " at offset " + to_string (doMe.offset) + 
+					" failed: " + lastIOError ();
+				hasFailed.store (true, memory_order_release);
+			}
+			numCompleted.fetch_add (1, memory_order_release);
+		}
+		workDone.notify_all ();
+	}
+}
+
+#endif
@@ -0,0 +1,77 @@
+
+#ifndef LRU_POLICY_C
+#define LRU_POLICY_C
+
+#include <algorithm>
+#include <climits>
+#include "MyDB_LRUPolicy.h"
+
+MyDB_LRUPolicy :: MyDB_LRUPolicy (size_t numFrames) : timeTicks (numFrames, -1) {
+	lastTimeTick = 0;
+	lastDemotedTick = LONG_MIN / 2;
+	numActive = numFrames;
+}
+
+void MyDB_LRUPolicy :: setNumFrames (size_t numFrames) {
+	numActive = numFrames;
+}
+
+void MyDB_LRUPolicy :: add (size_t whichFrame, uint64_t) {
+	if (timeTicks[whichFrame] != -1)
+		return;
+	timeTicks[whichFrame] = ++lastTimeTick;
+	lastUsed.insert (make_pair (timeTicks[whichFrame], whichFrame));
+}
+
+void MyDB_LRUPolicy :: touch (size_t whichFrame) {
+
+	// if this frame was just accessed (it is in the newer half of the buffer), get outta here...
+	// when there is more than one pool, the frames that this policy has are only part of the
+	// buffer, and the half is of those
+	long tick = timeTicks[whichFrame];
+	long half = (long) (min (numActive, lastUsed.size ()) / 2);
+	if (tick == -1 || tick > lastTimeTick - half)
+		return;
+
+	// otherwise, move it to the MRU end
+	lastUsed.erase (make_pair (tick, whichFrame));
+	timeTicks[whichFrame] = ++lastTimeTick;
+	lastUsed.insert (make_pair (timeTicks[whichFrame], whichFrame));
+}
+
+void MyDB_LRUPolicy :: demote (size_t whichFrame) {
+
+	// demoted ticks are all negative, so this skips a frame that is not in lastUsed (-1) and
+	// also one that is already demoted, which keeps its place in the FIFO order
+	long tick = timeTicks[whichFrame];
+	if (tick < 0)
+		return;
+	lastUsed.erase (make_pair (tick, whichFrame));
+	timeTicks[whichFrame] = ++lastDemotedTick;
+	lastUsed.insert (make_pair (timeTicks[whichFrame], whichFrame));
+}
+
+void MyDB_LRUPolicy :: remove (size_t whichFrame) {
+	if (timeTicks[whichFrame] == -1)
+		return;
+	lastUsed.erase (make_pair (timeTicks[whichFrame], whichFrame));
+	timeTicks[whichFrame] = -1;
+}
+
+long MyDB_LRUPolicy :: victim () {
+	if (lastUsed.size () == 0)
+		return -1;
+	size_t whichFrame = lastUsed.begin ()->second;
+	remove (whichFrame);
+	return whichFrame;
+}
+
+void MyDB_LRUPolicy :: coldest (size_t num, vector <size_t> &coldFrames) {
+	for (auto &f : lastUsed) {
+		if (num-- == 0)
+			return;
+		coldFrames.push_back (f.second);
+	}
+}
+
+#endif
@@ -0,0 +1,542 @@
+
+#ifndef LOG_MANAGER_C
+#define LOG_MANAGER_C
+
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <unistd.h>
+#include "MyDB_BufferManager.h"
+#include "MyDB_Checksum.h"
+#include "MyDB_FileIO.h"
+#include "MyDB_LogManager.h"
+
+using namespace std;
+
+// the log is read in pieces of this size during recovery
+#define LOG_READ_CHUNK (1024 * 1024)
+
+// the most pages that recovery keeps in RAM before writing them back to their files
+#define RECOVERY_PAGES 256
+
+// no record is ever this long, so a length that says otherwise is the torn end of the log
+#define MAX_LOG_RECORD (1UL << 30)
+
+// lastWrite when the last record cannot be added to, and lastPageKey when there is no last page
+#define NO_RECORD ((size_t) -1)
+#define NO_PAGE ((uint64_t) -1)
+
+// a page is keyed in loggedPages by its table's id and its page number
+static inline uint64_t logPageKey (uint32_t tableID, size_t whichPage) {
+	return (((uint64_t) tableID) << 40) | whichPage;
+}
+
+// helpers to build and take apart payloads
+static void putU32 (string &payload, uint32_t value) {
+	payload.append ((char *) &value, sizeof (value));
+}
+
+static void putU64 (string &payload, uint64_t value) {
+	payload.append ((char *) &value, sizeof (value));
+}
+
+static void putString (string &payload, const string &value) {
+	putU32 (payload, value.size ());
+	payload.append (value);
+}
+
+// these return false if the payload has run out
+static bool getU32 (const char *&at, const char *end, uint32_t &value) {
+	if (end - at < (long) sizeof (value))
+		return false;
+	memcpy (&value, at, sizeof (value));
+	at += sizeof (value);
+	return true;
+}
+
+static bool getU64 (const char *&at, const char *end, uint64_t &value) {
+	if (end - at < (long) sizeof (value))
+		return false;
+	memcpy (&value, at, sizeof (value));
+	at += sizeof (value);
+	return true;
+}
+
+static bool getString (const char *&at, const char *end, string &value) {
+	uint32_t length;
+	if (!getU32 (at, end, length) || end - at < (long) length)
+		return false;
+	value.assign (at, length);
+	at += length;
+	return true;
+}
+
+MyDB_LogManager :: MyDB_LogManager (string fNameIn, size_t pageSizeIn, size_t bufferSizeIn) {
+	fName = fNameIn;
+	pageSize = pageSizeIn;
+	bufferSize = bufferSizeIn;
+	fd = open (fName.c_str (), O_RDWR | O_CREAT, 0666);
+	if (fd == -1) {
+		cout << "Can't open the log " << fName << ": " << lastIOError () << "\n";
+		exit (1);
+	}
+	buffer.reserve (bufferSize);
+	writing.reserve (bufferSize);
+	firstLSN = nextLSN = durableLSN = 0;
+	flushing = false;
+	started = false;
+	done = false;
+	lastPageKey = NO_PAGE;
+	lastWrite = NO_RECORD;
+	numFlushes = 0;
+	numBytesWritten = 0;
+	writer = thread (&MyDB_LogManager :: writeLoop, this);
+}
+
+MyDB_LogManager :: ~MyDB_LogManager () {
+	commit ();
+	{
+		lock_guard <mutex> guard (lock);
+		done = true;
+		writeNeeded.notify_one ();
+	}
+	writer.join ();
+	close (fd);
+}
+
+size_t MyDB_LogManager :: logWrite (MyDB_TablePtr whichTable, size_t whichPage, void *pageBytes, size_t offset,
+	size_t numBytes, size_t headerBytes) {
+
+	unique_lock <mutex> guard (lock);
+	uint32_t id = tableID (guard, whichTable);
+	char *bytes = (char *) pageBytes;
+
+	// the first change since the last checkpoint logs the whole page, since the copy of the
+	// page on disk might be torn by a crash
+	uint64_t key = logPageKey (id, whichPage);
+	if (key != lastPageKey && loggedPages.insert (key).second) {
+		lastPageKey = key;
+		scratch.clear ();
+		putU32 (scratch, id);
+		putU64 (scratch, whichPage);
+		return append (guard, MyDB_LogRecordType :: PageImage, scratch.data (), scratch.size (), bytes, pageSize);
+	}
+	lastPageKey = key;
+
+	// a write that picks up where the last record left off (as appends to a page do) just
+	// makes that record longer, with the new header at the end
+	if (lastWrite != NO_RECORD && key == lastWriteKey && offset == lastWriteEnd && headerBytes == lastWriteHeader &&
+		buffer.size () + numBytes <= bufferSize) {
+
+		LogRecordHeader header;
+		memcpy (&header, &buffer[lastWrite], sizeof (header));
+		size_t at = buffer.size () - headerBytes;
+		buffer.resize (buffer.size () + numBytes);
+		memcpy (&buffer[at], bytes + offset, numBytes);
+		memcpy (&buffer[at + numBytes], bytes, headerBytes);
+		lastRecordCRC = crc32c (lastRecordCRC, bytes + offset, numBytes);
+		header.checksum = crc32c (lastRecordCRC, bytes, headerBytes);
+		header.length += numBytes;
+		memcpy (&buffer[lastWrite], &header, sizeof (header));
+
+		lastWriteEnd += numBytes;
+		nextLSN += numBytes;
+		return nextLSN;
+	}
+
+	scratch.clear ();
+	putU32 (scratch, id);
+	putU64 (scratch, whichPage);
+	putU32 (scratch, offset);
+	putU32 (scratch, headerBytes);
+	size_t lsn = append (guard, MyDB_LogRecordType :: PageWrite, scratch.data (), scratch.size (), bytes + offset, numBytes,
+		bytes, headerBytes);
+	lastWrite = lastRecord;
+	lastWriteKey = key;
+	lastWriteEnd = offset + numBytes;
+	lastWriteHeader = headerBytes;
+	return lsn;
+}
+
+size_t MyDB_LogManager :: logClear (MyDB_TablePtr whichTable, size_t whichPage) {
+	unique_lock <mutex> guard (lock);
+	uint32_t id = tableID (guard, whichTable);
+	loggedPages.insert (logPageKey (id, whichPage));
+	scratch.clear ();
+	putU32 (scratch, id);
+	putU64 (scratch, whichPage);
+	return append (guard, MyDB_LogRecordType :: PageClear, scratch.data (), scratch.size ());
+}
+
+size_t MyDB_LogManager :: logCatalog (string key, string value) {
+	unique_lock <mutex> guard (lock);
+	scratch.clear ();
+	putString (scratch, key);
+	putString (scratch, value);
+	return append (guard, MyDB_LogRecordType :: Catalog, scratch.data (), scratch.size ());
+}
+
+void MyDB_LogManager :: commit () {
+	unique_lock <mutex> guard (lock);
+	size_t lsn = nextLSN;
+	while (durableLSN < lsn)
+		startWrite (guard);
+}
+
+void MyDB_LogManager :: flush (size_t lsn) {
+	unique_lock <mutex> guard (lock);
+	lsn = min (lsn, nextLSN);
+	while (durableLSN < lsn)
+		startWrite (guard);
+}
+
+size_t MyDB_LogManager :: getLSN () {
+	lock_guard <mutex> guard (lock);
+	return nextLSN;
+}
+
+size_t MyDB_LogManager :: getDurableLSN () {
+	lock_guard <mutex> guard (lock);
+	return durableLSN;
+}
+
+size_t MyDB_LogManager :: getNumFlushes () {
+	lock_guard <mutex> guard (lock);
+	return numFlushes;
+}
+
+size_t MyDB_LogManager :: getNumBytesWritten () {
+	lock_guard <mutex> guard (lock);
+	return numBytesWritten;
+}
+
+size_t MyDB_LogManager :: append (unique_lock <mutex> &guard, MyDB_LogRecordType type, const void *payload,
+	size_t payloadSize, const void *data, size_t dataSize, const void *tail, size_t tailSize) {
+
+	if (!started)
+		clearLog (guard);
+
+	// make room for the record, by handing the buffer to the writer... if he is still busy
+	// with the other one, this has to wait for him
+	LogRecordHeader header;
+	size_t length = sizeof (header) + payloadSize + dataSize + tailSize;
+	while (buffer.size () > 0 && buffer.size () + length > bufferSize)
+		startWrite (guard);
+
+	header.length = length;
+	header.type = (uint32_t) type;
+	lastRecordCRC = crc32c (0, &header.type, sizeof (header.type));
+	lastRecordCRC = crc32c (lastRecordCRC, payload, payloadSize);
+	lastRecordCRC = crc32c (lastRecordCRC, data, dataSize);
+	header.checksum = crc32c (lastRecordCRC, tail, tailSize);
+
+	size_t at = buffer.size ();
+	buffer.resize (at + length);
+	memcpy (&buffer[at], &header, sizeof (header));
+	memcpy (&buffer[at + sizeof (header)], payload, payloadSize);
+	if (dataSize > 0)
+		memcpy (&buffer[at + sizeof (header) + payloadSize], data, dataSize);
+	if (tailSize > 0)
+		memcpy (&buffer[at + sizeof (header) + payloadSize + dataSize], tail, tailSize);
+
+	lastRecord = at;
+	lastWrite = NO_RECORD;
+	nextLSN += length;
+	return nextLSN;
+}
+
+void MyDB_LogManager :: startWrite (unique_lock <mutex> &guard) {
+
+	// if the writer is busy, whatever we need might be in what he is writing
+	if (flushing) {
+		flushed.wait (guard);
+		return;
+	}
+	if (buffer.size () == 0)
+		return;
+
+	// hand him everything that is buffered, and let everybody keep logging into the other buffer
+	flushing = true;
+	swap (buffer, writing);
+	lastWrite = NO_RECORD;
+	writeNeeded.notify_one ();
+}
+
+void MyDB_LogManager :: writeLoop () {
+	unique_lock <mutex> guard (lock);
+	while (true) {
+		while (!flushing && !done)
+			writeNeeded.wait (guard);
+		if (!flushing)
+			return;
+
+		// what is being written ends where the records that have been logged since it was
+		// handed over start
+		size_t endLSN = nextLSN - buffer.size ();
+		size_t offset = endLSN - writing.size () - firstLSN;
+		guard.unlock ();
+
+		if (!writeFully (fd, writing.data (), writing.size (), offset) || fdatasync (fd) != 0) {
+			cout << "Can't write the log " << fName << ": " << lastIOError () << "\n";
+			exit (1);
+		}
+
+		guard.lock ();
+		numFlushes++;
+		numBytesWritten += writing.size ();
+		writing.clear ();
+		durableLSN = endLSN;
+		flushing = false;
+		flushed.notify_all ();
+	}
+}
+
+uint32_t MyDB_LogManager :: tableID (unique_lock <mutex> &guard, MyDB_TablePtr whichTable) {
+
+	if (!started)
+		clearLog (guard);
+
+	auto found = knownTables.find (whichTable.get ());
+	if (found != knownTables.end ())
+		return found->second;
+
+	// some other object for the same file may already have an id
+	uint32_t id;
+	auto foundFile = tableIDs.find (whichTable->getStorageLoc ());
+	if (foundFile != tableIDs.end ()) {
+		id = foundFile->second;
+	} else {
+		id = tableIDs.size ();
+		tableIDs[whichTable->getStorageLoc ()] = id;
+		string payload;
+		putU32 (payload, id);
+		putString (payload, whichTable->getName ());
+		putString (payload, whichTable->getStorageLoc ());
+		append (guard, MyDB_LogRecordType :: Table, payload.data (), payload.size ());
+	}
+
+	knownTables[whichTable.get ()] = id;
+	tables.push_back (whichTable);
+	return id;
+}
+
+void MyDB_LogManager :: clearLog (unique_lock <mutex> &guard) {
+
+	// nobody can be writing the log out now
+	while (flushing)
+		flushed.wait (guard);
+
+	if (ftruncate (fd, 0) != 0 || fsync (fd) != 0) {
+		cout << "Can't clear out the log " << fName << ": " << lastIOError () << "\n";
+		exit (1);
+	}
+	buffer.clear ();
+	firstLSN = durableLSN = nextLSN;
+	tableIDs.clear ();
+	knownTables.clear ();
+	tables.clear ();
+	loggedPages.clear ();
+	lastPageKey = NO_PAGE;
+	lastWrite = NO_RECORD;
+	started = true;
+
+	string payload;
+	putU64 (payload, pageSize);
+	append (guard, MyDB_LogRecordType :: Start, payload.data (), payload.size ());
+}
+
+// reads the records of a log file, one after another
+class LogReader {
+
+public:
+
+	LogReader (int fdIn) : fd (fdIn), fileOffset (0), start (0), end (0) {}
+
+	// gets the next record; returns false at the end of the log, or at a record that is torn
+	bool next (uint32_t &type, const char *&payload, size_t &payloadSize) {
+		LogRecordHeader header;
+		if (!fill (sizeof (header)))
+			return false;
+		memcpy (&header, &chunk[start], sizeof (header));
+		if (header.length < sizeof (header) || header.length > MAX_LOG_RECORD || !fill (header.length))
+			return false;
+
+		payload = &chunk[start + sizeof (header)];
+		payloadSize = header.length - sizeof (header);
+		uint32_t checksum = crc32c (crc32c (0, &header.type, sizeof (header.type)), payload, payloadSize);
+		if (checksum != header.checksum)
+			return false;
+
+		type = header.type;
+		start += header.length;
+		return true;
+	}
+
+private:
+
+	// makes sure that there are at least numBytes unread bytes in the chunk; returns false
+	// if the file runs out first
+	bool fill (size_t numBytes) {
+		if (end - start >= numBytes)
+			return true;
+		chunk.erase (chunk.begin (), chunk.begin () + start);
+		end -= start;
+		start = 0;
+		while (end < numBytes) {
+			chunk.resize (max (numBytes, (size_t) LOG_READ_CHUNK) + end);
+			ssize_t numRead = pread (fd, &chunk[end], chunk.size () - end, fileOffset);
+			if (numRead <= 0)
+				return false;
+			fileOffset += numRead;
+			end += numRead;
+		}
+		return true;
+	}
+
+	int fd;
+	size_t fileOffset;
+	vector <char> chunk;
+	size_t start;
+	size_t end;
+};
+
+size_t MyDB_LogManager :: recover (MyDB_CatalogPtr catalog, bool pageChecksums) {
+
+	// the files of the tables in the log, by id
+	map <uint32_t, string> fileNames;
+	map <string, int> files;
+
+	// the pages that have been redone and not written back yet
+	map <pair <uint32_t, uint64_t>, vector <char>> pages;
+
+	auto getFile = [&] (uint32_t id) {
+		string &fileName = fileNames[id];
+		if (files.count (fileName) == 0) {
+			int fileFD = open (fileName.c_str (), O_RDWR | O_CREAT, 0666);
+			if (fileFD == -1) {
+				cout << "Can't open " << fileName << " to recover it: " << lastIOError () << "\n";
+				exit (1);
+			}
+			files[fileName] = fileFD;
+		}
+		return files[fileName];
+	};
+
+	auto writePages = [&] () {
+		for (auto &page : pages) {
+			char *bytes = page.second.data ();
+			if (pageChecksums)
+				setPageChecksum (bytes, pageSize);
+			else if (pageSize >= PAGE_CHECKSUM_OFFSET + sizeof (uint32_t))
+				memset (bytes + PAGE_CHECKSUM_OFFSET, 0, sizeof (uint32_t));
+			if (!writeFully (getFile (page.first.first), bytes, pageSize, page.first.second * pageSize)) {
+				cout << "Can't write page " << page.first.second << " of " << fileNames[page.first.first] <<
+					" to recover it: " << lastIOError () << "\n";
+				exit (1);
+			}
+		}
+		pages.clear ();
+	};
+
+	LogReader reader (fd);
+	uint32_t type;
+	const char *payload;
+	size_t payloadSize;
+	size_t numRedone = 0;
+	bool ok = true;
+	while (ok && reader.next (type, payload, payloadSize)) {
+
+		const char *at = payload, *end = payload + payloadSize;
+		uint32_t id;
+		uint64_t whichPage;
+
+		// the log has to be from a buffer with the same page size
+		if (type == (uint32_t) MyDB_LogRecordType :: Start) {
+			uint64_t logPageSize;
+			ok = getU64 (at, end, logPageSize);
+			if (ok && logPageSize != pageSize) {
+				cout << "The log " << fName << " was written with " << logPageSize << "-byte pages, not " << pageSize << "\n";
+				exit (1);
+			}
+
+		} else if (type == (uint32_t) MyDB_LogRecordType :: Table) {
+			string name, fileName;
+			ok = getU32 (at, end, id) && getString (at, end, name) && getString (at, end, fileName);
+			if (ok)
+				fileNames[id] = fileName;
+
+		} else if (type == (uint32_t) MyDB_LogRecordType :: Catalog) {
+			string key, value;
+			ok = getString (at, end, key) && getString (at, end, value);
+			if (ok) {
+				catalog->putString (key, value);
+				numRedone++;
+			}
+
+		// everything else is a change to a page
+		} else {
+			uint32_t offset = 0, headerBytes = 0;
+			ok = getU32 (at, end, id) && getU64 (at, end, whichPage) && fileNames.count (id) > 0;
+			if (ok && type == (uint32_t) MyDB_LogRecordType :: PageImage)
+				ok = (size_t) (end - at) == pageSize;
+			else if (ok && type == (uint32_t) MyDB_LogRecordType :: PageWrite)
+				ok = getU32 (at, end, offset) && getU32 (at, end, headerBytes) && headerBytes <= (size_t) (end - at) &&
+					headerBytes <= pageSize && offset + (size_t) (end - at) - headerBytes <= pageSize;
+			else if (ok)
+				ok = type == (uint32_t) MyDB_LogRecordType :: PageClear;
+			if (!ok)
+				break;
+
+			// a page that is only written to starts out as it is on disk
+			vector <char> &page = pages[make_pair (id, whichPage)];
+			if (page.size () == 0) {
+				page.resize (pageSize);
+				if (type == (uint32_t) MyDB_LogRecordType :: PageWrite &&
+					!readFully (getFile (id), page.data (), pageSize, whichPage * pageSize)) {
+					cout << "Can't read page " << whichPage << " of " << fileNames[id] << " to recover it: "
+						<< lastIOError () << "\n";
+					exit (1);
+				}
+			}
+
+			if (type == (uint32_t) MyDB_LogRecordType :: PageImage)
+				memcpy (page.data (), at, pageSize);
+			else if (type == (uint32_t) MyDB_LogRecordType :: PageClear)
+				memset (page.data (), 0, pageSize);
+			else {
+				memcpy (page.data () + offset, at, end - at - headerBytes);
+				memcpy (page.data (), end - headerBytes, headerBytes);
+			}
+
+			numRedone++;
+			if (pages.size () >= RECOVERY_PAGES)
+				writePages ();
+		}
+	}
+
+	// make everything that was redone durable, and then start the log over
+	writePages ();
+	for (auto &file : files) {
+		if (fsync (file.second) != 0) {
+			cout << "Can't sync " << file.first << " to recover it: " << lastIOError () << "\n";
+			exit (1);
+		}
+		close (file.second);
+	}
+	catalog->save ();
+
+	unique_lock <mutex> guard (lock);
+	clearLog (guard);
+	return numRedone;
+}
+
+void MyDB_LogManager :: checkpoint (MyDB_BufferManager &buffer, MyDB_CatalogPtr catalog) {
+	commit ();
+	buffer.writeBackAll ();
+	catalog->save ();
+	unique_lock <mutex> guard (lock);
+	clearLog (guard);
+}
+
+#endif
@@ -14,10 +14,12 @@
 
 #include "MyDB_BufferManager.h"
 #include "MyDB_Page.h"
+#include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
 
-void *MyDB_Page :: getBytes (MyDB_PagePtr me) {
-	parent.access (me);	
+void *MyDB_Page :: getBytes () {
+	if (!parent.access (me))
+		return nullptr;
 	return bytes;
 }
 
@@ -28,20 +30,42 @@ void MyDB_Page :: wroteBytes () {
 MyDB_Page :: ~MyDB_Page () {}
 
 MyDB_Page :: MyDB_Page (MyDB_TablePtr myTableIn, size_t iin, MyDB_BufferManager &parentIn) : 
-	parent (parentIn), myTable (myTableIn), pos (iin) { 
+	parent (parentIn), myTable (myTableIn), pos (iin), slot (0), fd (-1), pool (0), shard (0), counters (nullptr) { 
 	bytes = nullptr;
 	isDirty = false;	
+	discardable = false;
 	refCount = 0;
-	timeTick = -1;
+	frame = -1;
+	mapped = false;
+	pinCount = 0;
+	loading = false;
+	scanned = false;
+	readTicket = -1;
+	writeTicket = -1;
+	readAhead = false;
+	lsn = 0;
 }
 
-void MyDB_Page :: killpage (MyDB_PagePtr me) {
-	parent.killPage (me);
+void MyDB_Page :: killpage () {
+	parent.killPage (this);
 }
 
 MyDB_BufferManager &MyDB_Page :: getParent () {
 	return parent;	
 }
 
+bool MyDB_PageHandle :: pin () {
+	return page->getParent ().pin (page->me);
+}
+
+void MyDB_PageHandle :: unpin () {
+	page->getParent ().unpin (page->me);
+}
+
+void MyDB_PageHandle :: setLSN (size_t lsn) {
+	size_t current = page->lsn.load ();
+	while (current < lsn && !page->lsn.compare_exchange_weak (current, lsn));
+}
+
 #endif
 
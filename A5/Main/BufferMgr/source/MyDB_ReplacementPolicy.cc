@@ -0,0 +1,18 @@
+
+#ifndef REPLACEMENT_POLICY_C
+#define REPLACEMENT_POLICY_C
+
+#include "MyDB_ClockPolicy.h"
+#include "MyDB_LRUPolicy.h"
+#include "MyDB_ReplacementPolicy.h"
+#include "MyDB_TwoQPolicy.h"
+
+MyDB_ReplacementPolicyPtr MyDB_ReplacementPolicy :: create (MyDB_ReplacementType whichType, size_t numFrames) {
+	if (whichType == MyDB_ReplacementType :: ClockReplacement)
+		return make_shared <MyDB_ClockPolicy> (numFrames);
+	if (whichType == MyDB_ReplacementType :: TwoQReplacement)
+		return make_shared <MyDB_TwoQPolicy> (numFrames);
+	return make_shared <MyDB_LRUPolicy> (numFrames);
+}
+
+#endif
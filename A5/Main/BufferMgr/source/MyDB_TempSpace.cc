@@ -0,0 +1,96 @@
+
+#ifndef TEMP_SPACE_C
+#define TEMP_SPACE_C
+
+#include "MyDB_TempSpace.h"
+
+MyDB_TempSpace :: MyDB_TempSpace () {
+	end = 0;
+	numFree = 0;
+	numReleased = 0;
+}
+
+size_t MyDB_TempSpace :: allocate (size_t numSlots) {
+
+	// first fit, which keeps the file as short as we can
+	for (auto it = freeExtents.begin (); it != freeExtents.end (); it++) {
+		if (it->second.numSlots < numSlots)
+			continue;
+
+		size_t first = it->first;
+		Extent rest = it->second;
+		freeExtents.erase (it);
+		if (rest.numSlots > numSlots) {
+			rest.numSlots -= numSlots;
+			freeExtents[first + numSlots] = rest;
+		}
+		numFree -= numSlots;
+		return first;
+	}
+
+	// nothing is big enough, so grow the file
+	size_t first = end;
+	end += numSlots;
+	return first;
+}
+
+void MyDB_TempSpace :: release (size_t first, size_t numSlots) {
+
+	if (numSlots == 0)
+		return;
+	numReleased += numSlots;
+	Extent freed {numSlots, false};
+
+	// merge with the extent right after this one, if it is free
+	auto next = freeExtents.find (first + numSlots);
+	if (next != freeExtents.end ()) {
+		freed.numSlots += next->second.numSlots;
+		freeExtents.erase (next);
+	}
+
+	// and with the one right before
+	auto prev = freeExtents.lower_bound (first);
+	if (prev != freeExtents.begin ()) {
+		prev--;
+		if (prev->first + prev->second.numSlots == first) {
+			first = prev->first;
+			freed.numSlots += prev->second.numSlots;
+			freeExtents.erase (prev);
+		}
+	}
+
+	// if this is the last extent in the file, the file now ends before it
+	numFree += numSlots;
+	if (first + freed.numSlots == end) {
+		end = first;
+		numFree -= freed.numSlots;
+	} else {
+		freeExtents[first] = freed;
+	}
+}
+
+size_t MyDB_TempSpace :: getEnd () {
+	return end;
+}
+
+size_t MyDB_TempSpace :: getNumFree () {
+	return numFree;
+}
+
+size_t MyDB_TempSpace :: getNumReleased () {
+	return numReleased;
+}
+
+vector <pair <size_t, size_t>> MyDB_TempSpace :: takeHoles (size_t minSlots) {
+	vector <pair <size_t, size_t>> holes;
+	for (auto &extent : freeExtents) {
+		if (!extent.second.punched && extent.second.numSlots >= minSlots) {
+			holes.push_back (make_pair (extent.first, extent.second.numSlots));
+			extent.second.punched = true;
+		}
+	}
+	numReleased = 0;
+	return holes;
+}
+
+#endif
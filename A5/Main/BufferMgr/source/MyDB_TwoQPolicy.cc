@@ -0,0 +1,173 @@
+
+#ifndef TWO_Q_POLICY_C
+#define TWO_Q_POLICY_C
+
+#include "MyDB_TwoQPolicy.h"
+
+MyDB_TwoQPolicy :: MyDB_TwoQPolicy (size_t numFrames) : prev (numFrames, -1), next (numFrames, -1), 
+	onQueue (numFrames, NoQueue), pinnedFrom (numFrames, NoQueue), pageOf (numFrames, 0) {
+	setNumFrames (numFrames);
+	nextSeq = 0;
+}
+
+void MyDB_TwoQPolicy :: setNumFrames (size_t numFrames) {
+
+	// these are the settings recommended in the 2Q paper... if there are now too many ghosts,
+	// the extras go the next time that one is added
+	maxIn = numFrames / 4 > 0 ? numFrames / 4 : 1;
+	maxGhosts = numFrames / 2 > 0 ? numFrames / 2 : 1;
+}
+
+void MyDB_TwoQPolicy :: add (size_t whichFrame, uint64_t whichPage) {
+
+	if (onQueue[whichFrame] != NoQueue)
+		return;
+	pageOf[whichFrame] = whichPage;
+
+	// a page that is being unpinned was already buffered when it was pinned, and the pin
+	// was another access to it... so an A1in page goes back on A1in, and a page that was
+	// on Am (or that a scan was done with, as in touch) goes on Am
+	Queue wasOn = (Queue) pinnedFrom[whichFrame];
+	pinnedFrom[whichFrame] = NoQueue;
+	if (wasOn == InQueue) {
+		pushHead (InQueue, whichFrame);
+
+	// if we remember this guy, this is a reuse
+	} else if (wasOn != NoQueue || ghostSeqs.remove (whichPage)) {
+		pushHead (MainQueue, whichFrame);
+	} else {
+		pushHead (InQueue, whichFrame);
+	}
+}
+
+void MyDB_TwoQPolicy :: touch (size_t whichFrame) {
+
+	// a demoted page that somebody wants is being reused; an Am page moves to the MRU end;
+	// and an A1in page stays put, since the access is probably correlated with the first one
+	if (onQueue[whichFrame] == ScanQueue || onQueue[whichFrame] == MainQueue) {
+		unlink (whichFrame);
+		pushHead (MainQueue, whichFrame);
+	}
+}
+
+void MyDB_TwoQPolicy :: demote (size_t whichFrame) {
+	if (onQueue[whichFrame] == NoQueue || onQueue[whichFrame] == ScanQueue)
+		return;
+	unlink (whichFrame);
+	pushHead (ScanQueue, whichFrame);
+}
+
+void MyDB_TwoQPolicy :: remove (size_t whichFrame) {
+	pinnedFrom[whichFrame] = NoQueue;
+	unlink (whichFrame);
+}
+
+void MyDB_TwoQPolicy :: pin (size_t whichFrame) {
+	pinnedFrom[whichFrame] = onQueue[whichFrame];
+	unlink (whichFrame);
+}
+
+long MyDB_TwoQPolicy :: victim () {
+
+	long whichFrame;
+
+	// demoted scan pages go first, then A1in if it is over its target size, then Am
+	if (queues[ScanQueue].size > 0) {
+		whichFrame = queues[ScanQueue].tail;
+	} else if (queues[InQueue].size > 0 && (queues[InQueue].size > maxIn || queues[MainQueue].size == 0)) {
+		whichFrame = queues[InQueue].tail;
+		addGhost (pageOf[whichFrame]);
+	} else if (queues[MainQueue].size > 0) {
+		whichFrame = queues[MainQueue].tail;
+	} else {
+		return -1;
+	}
+
+	pinnedFrom[whichFrame] = NoQueue;
+	unlink (whichFrame);
+	return whichFrame;
+}
+
+void MyDB_TwoQPolicy :: coldest (size_t num, vector <size_t> &coldFrames) {
+
+	// this follows victim (): the scan queue, then the part of A1in that is over its
+	// target, then Am, then the rest of A1in
+	size_t overIn = queues[InQueue].size > maxIn ? queues[InQueue].size - maxIn : 0;
+	long whichFrame = queues[ScanQueue].tail;
+	for (; whichFrame != -1 && num > 0; whichFrame = prev[whichFrame], num--)
+		coldFrames.push_back (whichFrame);
+	whichFrame = queues[InQueue].tail;
+	for (; whichFrame != -1 && num > 0 && overIn > 0; whichFrame = prev[whichFrame], num--, overIn--)
+		coldFrames.push_back (whichFrame);
+	long inFrame = whichFrame;
+	for (whichFrame = queues[MainQueue].tail; whichFrame != -1 && num > 0; whichFrame = prev[whichFrame], num--)
+		coldFrames.push_back (whichFrame);
+	for (whichFrame = inFrame; whichFrame != -1 && num > 0; whichFrame = prev[whichFrame], num--)
+		coldFrames.push_back (whichFrame);
+}
+
+void MyDB_TwoQPolicy :: pushHead (Queue whichQueue, size_t whichFrame) {
+	FrameList &list = queues[whichQueue];
+	prev[whichFrame] = -1;
+	next[whichFrame] = list.head;
+	if (list.head != -1)
+		prev[list.head] = whichFrame;
+	else
+		list.tail = whichFrame;
+	list.head = whichFrame;
+	list.size++;
+	onQueue[whichFrame] = whichQueue;
+}
+
+void MyDB_TwoQPolicy :: unlink (size_t whichFrame) {
+
+	if (onQueue[whichFrame] == NoQueue)
+		return;
+
+	FrameList &list = queues[(int) onQueue[whichFrame]];
+	if (prev[whichFrame] != -1)
+		next[prev[whichFrame]] = next[whichFrame];
+	else
+		list.head = next[whichFrame];
+	if (next[whichFrame] != -1)
+		prev[next[whichFrame]] = prev[whichFrame];
+	else
+		list.tail = prev[whichFrame];
+	list.size--;
+
+	prev[whichFrame] = next[whichFrame] = -1;
+	onQueue[whichFrame] = NoQueue;
+}
+
+void MyDB_TwoQPolicy :: addGhost (uint64_t whichPage) {
+
+	ghostSeqs.insert (whichPage, nextSeq);
+	ghosts.push_back (make_pair (whichPage, nextSeq));
+	nextSeq++;
+
+	// forget the oldest ghosts, skipping over entries that are no longer live
+	while (ghosts.size () > 0) {
+		uint64_t *seq = ghostSeqs.find (ghosts.front ().first);
+		bool live = (seq != nullptr && *seq == ghosts.front ().second);
+		if (live && ghostSeqs.size () <= maxGhosts)
+			break;
+		if (live)
+			ghostSeqs.remove (ghosts.front ().first);
+		ghosts.pop_front ();
+	}
+
+	// pages that came back into the buffer leave dead entries behind them in the deque,
+	// and those only get skipped once they reach the front... if they start to pile up,
+	// squeeze them out so that the deque stays proportional to the number of ghosts
+	if (ghosts.size () > 2 * maxGhosts) {
+		deque <pair <uint64_t, uint64_t>> live;
+		for (auto &entry : ghosts) {
+			uint64_t *seq = ghostSeqs.find (entry.first);
+			if (seq != nullptr && *seq == entry.second)
+				live.push_back (entry);
+		}
+		ghosts.swap (live);
+	}
+}
+
+#endif
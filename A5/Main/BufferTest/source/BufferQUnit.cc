@@ -3,11 +3,21 @@
 #define CATALOG_UNIT_H
 
 #include "MyDB_BufferManager.h"
+#include "MyDB_BufferTrace.h"
+#include "MyDB_Checksum.h"
+#include "MyDB_FrameArena.h"
+#include "MyDB_LogManager.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
+#include "MyDB_TempSpace.h"
 #include "QUnit.h"
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <sys/stat.h>
+#include <thread>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -27,10 +37,10 @@ int main () {
 		cout << "get page..." << flush;
 		MyDB_PageHandle page1 = myMgr.getPage();
 		cout << "get bytes..." << flush;
-		char *bytes = (char *)page1->getBytes();
+		char *bytes = (char *)page1.getBytes();
 		cout << "write bytes..." << flush;
 		memset(bytes, 'A', 64);
-		page1->wroteBytes();
+		page1.wroteBytes();
 		cout << "shutdown manager..." << flush;
 	}
 	cout << "COMPLETE" << endl << flush;
@@ -47,13 +57,13 @@ int main () {
 		MyDB_PageHandle page1 = myMgr.getPage(table1, 0);
 		MyDB_PageHandle page2 = myMgr.getPinnedPage(table2, 1);
 		cout << "get bytes..." << flush;
-		char *bytes1 = (char *)page1->getBytes();
-		char *bytes2 = (char *)page2->getBytes();
+		char *bytes1 = (char *)page1.getBytes();
+		char *bytes2 = (char *)page2.getBytes();
 		cout << "write bytes..." << flush;
 		memset(bytes1, 'A', 64);
-		page1->wroteBytes();
+		page1.wroteBytes();
 		memset(bytes2, 'B', 64);
-		page2->wroteBytes();
+		page2.wroteBytes();
 		cout << "shutdown manager..." << flush;
 	}
 	cout << "COMPLETE" << endl << flush;
@@ -71,8 +81,8 @@ int main () {
 		MyDB_PageHandle page1 = myMgr.getPage(table1, 0);
 		MyDB_PageHandle page2 = myMgr.getPinnedPage(table2, 1);
 		cout << "get bytes..." << flush;
-		char *bytes1 = (char *)page1->getBytes();
-		char *bytes2 = (char *)page2->getBytes();
+		char *bytes1 = (char *)page1.getBytes();
+		char *bytes2 = (char *)page2.getBytes();
 		cout << "compare bytes..." << flush;
 		for (int i = 0; i < 64; i++) {
 			if (bytes1[i] != 'A') flag3 = false;
@@ -99,12 +109,12 @@ int main () {
 		cout << "get bytes..." << flush;
 		vector<char*> bytes(16);
 		for (int i = 0; i < 16; i++) {
-			bytes[i] = (char *)pages[i]->getBytes();
+			bytes[i] = (char *)pages[i].getBytes();
 		}
 		cout << "write bytes..." << flush;
 		for (int i = 0; i < 16; i++) {
 			memset(bytes[i], 'C', 1048576);
-			pages[i]->wroteBytes();
+			pages[i].wroteBytes();
 		}
 		cout << "shutdown manager..." << flush;
 	}
@@ -125,7 +135,7 @@ int main () {
 		cout << "get bytes..." << flush;
 		vector<char*> bytes(100000);
 		for (int i = 0; i < 100000; i++) {
-			bytes[i] = (char *)pages[i]->getBytes();
+			bytes[i] = (char *)pages[i].getBytes();
 		}
 		cout << "shutdown manager..." << flush;
 	}
@@ -151,13 +161,13 @@ int main () {
 		volatile char *bytes1, *bytes2;
 		t1 = clock(); 
 		for (int i = 0; i < 100000; i++) {
-			bytes1 = (char *)pages[13]->getBytes();
-			bytes2 = (char *)pages[14]->getBytes();
+			bytes1 = (char *)pages[13].getBytes();
+			bytes2 = (char *)pages[14].getBytes();
 		}
 		t2 = clock();
 		for (int i = 0; i < 100000; i++) {
-			bytes1 = (char *)pages[15]->getBytes();
-			bytes2 = (char *)pages[16]->getBytes();
+			bytes1 = (char *)pages[15].getBytes();
+			bytes2 = (char *)pages[16].getBytes();
 		}
 		t3 = clock();
 		cout << t2 - t1 << "..." << t3 - t2 << "...";
@@ -183,13 +193,13 @@ int main () {
 		t1 = clock(); 
 		for (int i = 0; i < 1000; i++) {
 			for (int j = 0; j < 100; j++) {
-				bytes1 = (char *)pages[j]->getBytes();
+				bytes1 = (char *)pages[j].getBytes();
 			}
 		}
 		t2 = clock();
 		for (int i = 0; i < 1000; i++) {
 			for (int j = 0; j < 101; j++) {
-				bytes1 = (char *)pages[j]->getBytes();
+				bytes1 = (char *)pages[j].getBytes();
 			}
 		}
 		t3 = clock();
@@ -213,13 +223,13 @@ int main () {
 		cout << "write bytes..." << flush;
 		vector<char*> bytes(50);
 		for (int i = 0; i < 50; i++) {
-			bytes[i] = (char *)pages[i]->getBytes();
+			bytes[i] = (char *)pages[i].getBytes();
 			memset(bytes[i], (char)('A' + i), 64);
-			pages[i]->wroteBytes();
+			pages[i].wroteBytes();
 		}
 		cout << "read bytes..." << flush;
 		for (int i = 0; i < 50; i++) {
-			bytes[i] = (char *)pages[i]->getBytes();
+			bytes[i] = (char *)pages[i].getBytes();
 			char c = (char)('A' + i);
 			for (int j = 0; j < 64; j++) {
 				if (bytes[i][j] != c) flag8 = false;
@@ -250,18 +260,18 @@ int main () {
 		}
 		cout << "write bytes..." << flush;
 		for (int i = 0; i < 16; i++) {
-			char *bytes = (char *)pagesA[i]->getBytes();
+			char *bytes = (char *)pagesA[i].getBytes();
 			memset(bytes, (char)('A' + i), 64);
-			pagesA[i]->wroteBytes();
+			pagesA[i].wroteBytes();
 		}
 		for (int i = 0; i < 16; i++) {
-			char *bytes = (char *)pagesB[i]->getBytes();
+			char *bytes = (char *)pagesB[i].getBytes();
 			memset(bytes, (char)('a' + i), 64);
-			pagesB[i]->wroteBytes();
+			pagesB[i].wroteBytes();
 		}
 		cout << "read bytes..." << flush;
 		for (int i = 0; i < 16; i++) {
-			char *bytes = (char *)pagesC[i]->getBytes();
+			char *bytes = (char *)pagesC[i].getBytes();
 			char c = (char)('a' + i);
 			for (int j = 0; j < 64; j++) {
 				if (bytes[j] != c) flag9 = false;
@@ -271,6 +281,967 @@ int main () {
 	}
 	cout << "COMPLETE" << endl << flush;
 	QUNIT_IS_TRUE(flag9);
+
+	// CLOCK replacement, with pinned pages mixed in
+	bool flag10 = true;
+	cout << "TEST 10..." << flush;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD", MyDB_ReplacementType :: ClockReplacement);
+		cout << "get page..." << flush;
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		vector<MyDB_PageHandle> pinned(8);
+		for (int i = 0; i < 8; i++) {
+			pinned[i] = myMgr.getPinnedPage(table1, i);
+		}
+		vector<MyDB_PageHandle> pages(50);
+		for (int i = 0; i < 50; i++) {
+			pages[i] = myMgr.getPage();
+		}
+		cout << "write bytes..." << flush;
+		for (int i = 0; i < 8; i++) {
+			memset(pinned[i].getBytes(), (char)('a' + i), 64);
+			pinned[i].wroteBytes();
+		}
+		for (int round = 0; round < 3; round++) {
+			for (int i = 0; i < 50; i++) {
+				char *bytes = (char *)pages[i].getBytes();
+				memset(bytes, (char)('A' + i), 64);
+				pages[i].wroteBytes();
+			}
+		}
+		cout << "read bytes..." << flush;
+		for (int i = 0; i < 50; i++) {
+			char *bytes = (char *)pages[i].getBytes();
+			for (int j = 0; j < 64; j++) {
+				if (bytes[j] != (char)('A' + i)) flag10 = false;
+			}
+		}
+		for (int i = 0; i < 8; i++) {
+			char *bytes = (char *)pinned[i].getBytes();
+			for (int j = 0; j < 64; j++) {
+				if (bytes[j] != (char)('a' + i)) flag10 = false;
+			}
+		}
+		if (flag10) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag10);
+
+	// 2Q, and a big scan that should not push out pages that are being reused
+	cout << "TEST 11..." << flush;
+	bool flag11 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD", MyDB_ReplacementType :: TwoQReplacement);
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		MyDB_TablePtr table2 = make_shared <MyDB_Table>("table2", "file2");
+		cout << "write hot pages..." << flush;
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table2, i);
+			memset(page.getBytes(), (char)('a' + i), 64);
+			page.wroteBytes();
+		}
+		cout << "scan..." << flush;
+		for (int i = 0; i < 100; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i, true);
+			page.getBytes();
+		}
+		cout << "read hot pages..." << flush;
+		size_t misses = myMgr.getNumMisses();
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table2, i);
+			char *bytes = (char *)page.getBytes();
+			for (int j = 0; j < 64; j++) {
+				if (bytes[j] != (char)('a' + i)) flag11 = false;
+			}
+		}
+		if (myMgr.getNumMisses() != misses) flag11 = false;
+		if (flag11) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag11);
+
+	// prefetching pages in the background
+	cout << "TEST 12..." << flush;
+	bool flag12 = true;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			cout << "write pages..." << flush;
+			for (int i = 0; i < 20; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table1, i);
+				memset(page.getBytes(), (char)('a' + i), 64);
+				page.wroteBytes();
+			}
+			cout << "shutdown manager..." << flush;
+		}
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		cout << "prefetch..." << flush;
+		myMgr.prefetch(table1, 0, 4);
+		myMgr.prefetch(table1, 4, 16);
+		cout << "read pages..." << flush;
+		for (int i = 0; i < 4; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			char *bytes = (char *)page.getBytes();
+			for (int j = 0; j < 64; j++) {
+				if (bytes[j] != (char)('a' + i)) flag12 = false;
+			}
+		}
+
+		// only a quarter of the buffer can be prefetched at once
+		if (myMgr.getNumMisses() != 0) flag12 = false;
+		for (int i = 4; i < 20; i++) {
+			MyDB_PageHandle page = myMgr.getPinnedPage(table1, i);
+			char *bytes = (char *)page.getBytes();
+			for (int j = 0; j < 64; j++) {
+				if (bytes[j] != (char)('a' + i)) flag12 = false;
+			}
+		}
+		if (flag12) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag12);
+
+	// the background flusher and batched write-back
+	cout << "TEST 13..." << flush;
+	bool flag13 = true;
+	{
+		MyDB_TablePtr table1 = make_shared <MyDB_Table>("table1", "file1");
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			myMgr.setCleanFraction(0.5);
+			cout << "write pages..." << flush;
+			for (int i = 0; i < 100; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table1, (i * 7) % 100);
+				memset(page.getBytes(), (char)('0' + (i * 7) % 100), 64);
+				page.wroteBytes();
+			}
+			if (myMgr.getNumBackgroundWrites() == 0) flag13 = false;
+			cout << "shutdown manager..." << flush;
+		}
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		cout << "read pages..." << flush;
+		for (int i = 0; i < 100; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table1, i);
+			char *bytes = (char *)page.getBytes();
+			for (int j = 0; j < 64; j++) {
+				if (bytes[j] != (char)('0' + i)) flag13 = false;
+			}
+		}
+		if (flag13) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag13);
+
+	// reading past the end of a file, and a page that straddles it
+	cout << "TEST 14..." << flush;
+	bool flag14 = true;
+	{
+		MyDB_TablePtr table3 = make_shared <MyDB_Table>("table3", "file3");
+		unlink ("file3");
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+			MyDB_PageHandle page = myMgr.getPage(table3, 0);
+			memset(page.getBytes(), 'x', 64);
+			page.wroteBytes();
+			cout << "shutdown manager..." << flush;
+		}
+
+		// chop the file in the middle of the page
+		truncate ("file3", 40);
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		cout << "read pages..." << flush;
+		char *bytes = (char *)myMgr.getPage(table3, 0).getBytes();
+		for (int j = 0; j < 64; j++) {
+			if (bytes[j] != (j < 40 ? 'x' : 0)) flag14 = false;
+		}
+		bytes = (char *)myMgr.getPinnedPage(table3, 3).getBytes();
+		for (int j = 0; j < 64; j++) {
+			if (bytes[j] != 0) flag14 = false;
+		}
+		if (flag14) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag14);
+
+	// a bunch of threads hammering on a sharded buffer at once
+	cout << "TEST 15..." << flush;
+	atomic <bool> flag15 (true);
+	{
+		const int numThreads = 4;
+		const int numPagesPerTable = 300;
+		MyDB_TablePtr shared = make_shared <MyDB_Table>("shared", "file5");
+		vector <MyDB_TablePtr> tables;
+		for (int t = 0; t < numThreads; t++)
+			tables.push_back(make_shared <MyDB_Table>("stress" + to_string(t), "stressFile" + to_string(t)));
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(64, 256, "tempDSFSD");
+			if (myMgr.getNumShards() != 4) flag15 = false;
+
+			// a table that every thread reads
+			for (int i = 0; i < 100; i++) {
+				MyDB_PageHandle page = myMgr.getPage(shared, i);
+				memset(page.getBytes(), (char)('a' + i % 26), 64);
+				page.wroteBytes();
+			}
+
+			cout << "start threads..." << flush;
+			vector <thread> threads;
+			for (int t = 0; t < numThreads; t++) {
+				threads.push_back(thread([&, t]() {
+					unsigned seed = t;
+					for (int rep = 0; rep < 3; rep++) {
+
+						// write this thread's own table
+						for (int i = 0; i < numPagesPerTable; i++) {
+							MyDB_PageHandle page = myMgr.getPage(tables[t], i);
+							if (!page.pin()) {
+								flag15 = false;
+								return;
+							}
+							memset(page.getBytes(), (char)('0' + (i + rep) % 50), 64);
+							page.wroteBytes();
+							page.unpin();
+
+							// read a page of the shared table
+							MyDB_PageHandle other = myMgr.getPinnedPage(shared, rand_r(&seed) % 100);
+							if (other == nullptr) {
+								flag15 = false;
+								return;
+							}
+							char *bytes = (char *)other.getBytes();
+							char expected = bytes[0];
+							for (int j = 0; j < 64; j++) {
+								if (bytes[j] != expected || expected < 'a' || expected > 'z') flag15 = false;
+							}
+
+							// and use a temp page
+							MyDB_PageHandle temp = myMgr.getPinnedPage();
+							if (temp == nullptr) {
+								flag15 = false;
+								return;
+							}
+							memset(temp.getBytes(), (char) t, 64);
+							temp.wroteBytes();
+							for (int j = 0; j < 64; j++) {
+								if (((char *)temp.getBytes())[j] != (char) t) flag15 = false;
+							}
+						}
+
+						// and check it
+						for (int i = 0; i < numPagesPerTable; i++) {
+							MyDB_PageHandle page = myMgr.getPinnedPage(tables[t], i);
+							if (page == nullptr) {
+								flag15 = false;
+								return;
+							}
+							char *bytes = (char *)page.getBytes();
+							for (int j = 0; j < 64; j++) {
+								if (bytes[j] != (char)('0' + (i + rep) % 50)) flag15 = false;
+							}
+						}
+					}
+				}));
+			}
+			for (auto &t : threads)
+				t.join();
+			cout << "shutdown manager..." << flush;
+		}
+
+		// everything written by the threads should have made it to disk
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		cout << "read pages..." << flush;
+		for (int t = 0; t < numThreads; t++) {
+			for (int i = 0; i < numPagesPerTable; i++) {
+				char *bytes = (char *)myMgr.getPage(tables[t], i).getBytes();
+				for (int j = 0; j < 64; j++) {
+					if (bytes[j] != (char)('0' + (i + 2) % 50)) flag15 = false;
+				}
+			}
+		}
+		if (flag15) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag15);
+
+	// the frames all come out of one aligned arena
+	cout << "TEST 16..." << flush;
+	bool flag16 = true;
+	{
+		cout << "create arena..." << flush;
+		MyDB_FrameArena arena(8192, 300);
+		if (!arena.isPageAligned() || arena.getStride() != 8192) flag16 = false;
+		if ((uintptr_t) arena.getFrame(0) % HUGE_PAGE_SIZE != 0) flag16 = false;
+		cout << "write frames..." << flush;
+		for (int i = 0; i < 300; i++) {
+			if ((uintptr_t) arena.getFrame(i) % FRAME_ALIGNMENT != 0) flag16 = false;
+			memset(arena.getFrame(i), (char) i, 8192);
+		}
+		for (int i = 0; i < 300; i++) {
+			char *bytes = (char *) arena.getFrame(i);
+			if (bytes[0] != (char) i || bytes[8191] != (char) i) flag16 = false;
+		}
+
+		// small frames are packed to a cache line
+		MyDB_FrameArena small(100, 10);
+		if (small.isPageAligned() || small.getStride() != 128) flag16 = false;
+
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+		for (int i = 0; i < 16; i++) {
+			MyDB_PageHandle page = myMgr.getPinnedPage();
+			if ((uintptr_t) page.getBytes() % FRAME_ALIGNMENT != 0) flag16 = false;
+		}
+		if (flag16) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag16);
+
+	// direct I/O, including a page that straddles the end of the file
+	cout << "TEST 17..." << flush;
+	bool flag17 = true;
+	{
+		MyDB_TablePtr table6 = make_shared <MyDB_Table>("table6", "file6");
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", MyDB_ReplacementType :: LRUReplacement, true);
+			if (!myMgr.usesDirectIO()) flag17 = false;
+			cout << "write pages..." << flush;
+			for (int i = 0; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table6, i);
+				memset(page.getBytes(), (char)('0' + i), 4096);
+				page.wroteBytes();
+			}
+			for (int i = 0; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPinnedPage();
+				memset(page.getBytes(), 't', 4096);
+				page.wroteBytes();
+			}
+			cout << "shutdown manager..." << flush;
+		}
+
+		// chop the file in the middle of the last page
+		truncate ("file6", 4096 * 39 + 100);
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", MyDB_ReplacementType :: LRUReplacement, true);
+		cout << "read pages..." << flush;
+		for (int i = 0; i < 40; i++) {
+			char *bytes = (char *)myMgr.getPage(table6, i).getBytes();
+			for (int j = 0; j < 4096; j++) {
+				if (bytes[j] != ((i < 39 || j < 100) ? (char)('0' + i) : 0)) flag17 = false;
+			}
+		}
+
+		// small pages cannot use direct I/O
+		MyDB_BufferManager smallMgr(64, 16, "tempDSFSD2", MyDB_ReplacementType :: LRUReplacement, true);
+		if (smallMgr.usesDirectIO()) flag17 = false;
+		if (flag17) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag17);
+
+	// a table mapped read-only
+	cout << "TEST 18..." << flush;
+	bool flag18 = true;
+	{
+		MyDB_TablePtr table7 = make_shared <MyDB_Table>("table7", "file7");
+		unlink ("file7");
+		{
+			cout << "create manager..." << flush;
+			MyDB_BufferManager myMgr(4096, 4, "tempDSFSD");
+			if (myMgr.mapReadOnly(table7)) flag18 = false;
+			cout << "write pages..." << flush;
+			for (int i = 0; i < 20; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table7, i);
+				memset(page.getBytes(), (char)('A' + i), 4096);
+				page.wroteBytes();
+			}
+			cout << "shutdown manager..." << flush;
+		}
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(4096, 4, "tempDSFSD");
+		if (!myMgr.mapReadOnly(table7)) flag18 = false;
+		cout << "read pages..." << flush;
+		myMgr.startScan(table7);
+		myMgr.prefetch(table7, 0, 20, true);
+		for (int i = 0; i < 20; i++) {
+			MyDB_PageHandle page = myMgr.getPinnedPage(table7, i);
+			if (page == nullptr || !page.pin()) {
+				flag18 = false;
+				break;
+			}
+			char *bytes = (char *)page.getBytes();
+			for (int j = 0; j < 4096; j++) {
+				if (bytes[j] != (char)('A' + i)) flag18 = false;
+			}
+			page.unpin();
+		}
+		myMgr.finishScan(table7);
+
+		// none of that needed a buffer frame, or a read
+		if (myMgr.getNumMisses() != 0) flag18 = false;
+
+		// a page past the end of the mapping is buffered as usual
+		{
+			MyDB_PageHandle page = myMgr.getPage(table7, 20);
+			memset(page.getBytes(), 'z', 4096);
+			page.wroteBytes();
+		}
+		if (((char *)myMgr.getPage(table7, 20).getBytes())[4095] != 'z') flag18 = false;
+		if (flag18) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag18);
+
+	// temp file space is handed out in extents, and given back
+	cout << "TEST 19..." << flush;
+	bool flag19 = true;
+	{
+		cout << "allocate extents..." << flush;
+		MyDB_TempSpace space;
+		if (space.allocate(1) != 0 || space.allocate(4) != 1 || space.allocate(1) != 5) flag19 = false;
+		space.release(1, 4);
+		if (space.allocate(2) != 1 || space.allocate(3) != 6 || space.getEnd() != 9) flag19 = false;
+		space.release(0, 1);
+		space.release(1, 2);
+		space.release(5, 1);
+		if (space.getNumFree() != 6 || space.getEnd() != 9) flag19 = false;
+		space.release(6, 3);
+		if (space.getNumFree() != 0 || space.getEnd() != 0) flag19 = false;
+
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		{
+			cout << "write temp pages..." << flush;
+			vector<MyDB_PageHandle> pages;
+			for (int i = 0; i < 100; i++) {
+				pages.push_back(myMgr.getPage());
+				memset(pages[i].getBytes(), 'a', 64);
+				pages[i].wroteBytes();
+			}
+			if (myMgr.getTempFileSize() != 100) flag19 = false;
+
+			// a run goes after everything that is in use, in one piece
+			cout << "reserve a run..." << flush;
+			for (int i = 10; i < 20; i++)
+				pages[i] = nullptr;
+			size_t first = myMgr.reserveTempPages(20);
+			if (first != 100 || myMgr.getNumFreeTempSlots() != 10) flag19 = false;
+			for (size_t i = 0; i < 15; i++) {
+				MyDB_PageHandle page = myMgr.getPage(first + i);
+				memset(page.getBytes(), 'b', 64);
+				page.wroteBytes();
+				pages.push_back(page);
+			}
+			myMgr.releaseTempPages(first + 15, 5);
+			cout << "release pages..." << flush;
+		}
+
+		// once nothing is left, the file is cut back to nothing
+		struct stat info;
+		if (myMgr.getTempFileSize() != 0 || myMgr.getNumFreeTempSlots() != 0) flag19 = false;
+		if (stat("tempDSFSD", &info) != 0 || info.st_size != 0) flag19 = false;
+		if (flag19) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag19);
+
+	// temp pages that nobody will read again are dropped, not written
+	cout << "TEST 20..." << flush;
+	bool flag20 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_TablePtr table8 = make_shared <MyDB_Table>("table8", "file8");
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		myMgr.setCleanFraction(0);
+
+		cout << "write temp pages..." << flush;
+		vector<MyDB_PageHandle> pages(16);
+		for (int i = 0; i < 16; i++) {
+			pages[i] = myMgr.getPage();
+			memset(pages[i].getBytes(), 'a' + i, 64);
+			pages[i].wroteBytes();
+			if (i < 8)
+				pages[i].setDiscardable();
+		}
+
+		// push all of them out with pages of a table
+		cout << "evict them..." << flush;
+		for (int i = 0; i < 16; i++)
+			myMgr.getPage(table8, i).getBytes();
+		if (myMgr.getNumAvoidedWrites() != 8 || myMgr.getNumEvictionWrites() != 8) flag20 = false;
+
+		// the ones that were written come back
+		for (int i = 8; i < 16; i++) {
+			if (((char *)pages[i].getBytes())[63] != 'a' + i) flag20 = false;
+		}
+
+		// and a dirty temp page that goes away while it is buffered is never written
+		cout << "drop a page..." << flush;
+		{
+			MyDB_PageHandle temp = myMgr.getPage();
+			memset(temp.getBytes(), 'z', 64);
+			temp.wroteBytes();
+		}
+		if (myMgr.getNumEvictionWrites() != 8) flag20 = false;
+		if (flag20) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	unlink("file8");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag20);
+
+	// statistics are kept by table, and every event can be traced
+	cout << "TEST 21..." << flush;
+	bool flag21 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_TablePtr table9 = make_shared <MyDB_Table>("table9", "file9");
+		MyDB_TablePtr table10 = make_shared <MyDB_Table>("table10", "file10");
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+		myMgr.setCleanFraction(0);
+		myMgr.startTrace("traceDSFSD");
+
+		cout << "access pages..." << flush;
+		for (int i = 0; i < 4; i++)
+			myMgr.getPage(table9, i).getBytes();
+		for (int i = 0; i < 4; i++)
+			myMgr.getPage(table9, i).getBytes();
+		{
+			vector<MyDB_PageHandle> pages;
+			for (int i = 0; i < 3; i++)
+				pages.push_back(myMgr.getPinnedPage(table10, i));
+			for (int i = 0; i < 5; i++)
+				pages.push_back(myMgr.getPinnedPage());
+			if (myMgr.getStats().numPinned != 8) flag21 = false;
+		}
+
+		cout << "check stats..." << flush;
+		MyDB_BufferStats stats = myMgr.getStats();
+		if (stats.byTable["table9"].numHits != 4 || stats.byTable["table9"].numMisses != 4) flag21 = false;
+		if (stats.byTable["table10"].numMisses != 3 || stats.byTable["table9"].bytesRead != 4 * 64) flag21 = false;
+		if (stats.byTable.count("<temp>") == 0 || stats.total.numMisses != 7) flag21 = false;
+		if (stats.numPinned != 0 || stats.maxPinned != 8 || stats.numFrames != 16) flag21 = false;
+		if (stats.tempFileGrowth != 5 || stats.maxTempFileSize != 5 || stats.tempFileSize != 0) flag21 = false;
+		myMgr.stopTrace();
+
+		// the trace has every access, with the table names
+		cout << "read trace..." << flush;
+		MyDB_TraceReader reader("traceDSFSD");
+		MyDB_TraceEvent event;
+		size_t counts[(int)MyDB_TraceEventType::SlotName] = {};
+		while (reader.next(event))
+			counts[event.type]++;
+		if (reader.getPageSize() != 64 || reader.getSlotName(1) != "table9" || reader.getSlotName(2) != "table10") flag21 = false;
+		if (counts[(int)MyDB_TraceEventType::Hit] != 4 || counts[(int)MyDB_TraceEventType::Miss] != 7) flag21 = false;
+		if (counts[(int)MyDB_TraceEventType::Pin] != 8 || counts[(int)MyDB_TraceEventType::Unpin] != 8) flag21 = false;
+		if (counts[(int)MyDB_TraceEventType::NewTempPage] != 5 || counts[(int)MyDB_TraceEventType::KillTempPage] != 5) flag21 = false;
+		if (flag21) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	unlink("file9");
+	unlink("file10");
+	unlink("traceDSFSD");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag21);
+
+	// frames are reserved up front, and running out of them is not fatal
+	cout << "TEST 22..." << flush;
+	bool flag22 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_TablePtr table11 = make_shared <MyDB_Table>("table11", "file11");
+		MyDB_BufferManager myMgr(64, 16, "tempDSFSD");
+
+		cout << "reserve frames..." << flush;
+		if (myMgr.getNumReservableFrames() != 15) flag22 = false;
+		MyDB_FrameReservationPtr first = myMgr.reserveFrames(4, 10);
+		MyDB_FrameReservationPtr second = myMgr.reserveFrames(4, 10, false);
+		if (first == nullptr || first->getNumFrames() != 10) flag22 = false;
+		if (second == nullptr || second->getNumFrames() != 5) flag22 = false;
+		if (myMgr.reserveFrames(2, 4, false) != nullptr || myMgr.reserveFrames(16, 16) != nullptr) flag22 = false;
+
+		// a reservation that does not fit waits for one to be given back
+		thread releaser([&]() {
+			usleep(50000);
+			first = nullptr;
+		});
+		MyDB_FrameReservationPtr third = myMgr.reserveFrames(8, 8);
+		releaser.join();
+		if (third == nullptr || third->getNumFrames() != 8 || myMgr.getNumReservedFrames() != 13) flag22 = false;
+		second = nullptr;
+		third = nullptr;
+		if (myMgr.getNumReservedFrames() != 0) flag22 = false;
+
+		// with every frame pinned, a pin fails, and so does reading a page... but nothing dies
+		cout << "pin every frame..." << flush;
+		vector<MyDB_PageHandle> pages;
+		for (int i = 0; i < 16; i++)
+			pages.push_back(myMgr.getPinnedPage());
+		myMgr.setFrameWait(0);
+		if (myMgr.getPinnedPage() != nullptr || myMgr.getPinnedPage(table11, 0) != nullptr) flag22 = false;
+		if (myMgr.getPage(table11, 1).getBytes() != nullptr) flag22 = false;
+
+		// but a thread that waits gets a frame once another one is unpinned
+		cout << "wait for a frame..." << flush;
+		myMgr.setFrameWait(5000);
+		thread unpinner([&]() {
+			usleep(50000);
+			pages[3].unpin();
+		});
+		MyDB_PageHandle page = myMgr.getPinnedPage(table11, 2);
+		unpinner.join();
+		if (page == nullptr || page.getBytes() == nullptr) flag22 = false;
+		if (flag22) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	unlink("file11");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag22);
+
+	// memory pools keep a busy pool from taking another pool's frames
+	cout << "TEST 23..." << flush;
+	bool flag23 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_TablePtr indexTable = make_shared <MyDB_Table>("index", "file12");
+		MyDB_TablePtr scanTable = make_shared <MyDB_Table>("scan", "file13");
+		MyDB_BufferManager myMgr(64, 64, "tempDSFSD");
+		myMgr.setCleanFraction(0);
+		if (!myMgr.createPool("index", 16, 24) || !myMgr.createPool("sort", 0, 16)) flag23 = false;
+		if (myMgr.createPool("index", 1, 1) || myMgr.createPool("huge", 60, 60)) flag23 = false;
+		if (!myMgr.setPool(indexTable, "index") || !myMgr.setTempPool("sort") || myMgr.setTempPool("none")) flag23 = false;
+
+		cout << "read index..." << flush;
+		for (int i = 0; i < 16; i++)
+			myMgr.getPage(indexTable, i).getBytes();
+		if (myMgr.getPoolSize("index") != 16) flag23 = false;
+
+		// a big sort stays within its maximum
+		cout << "write temp pages..." << flush;
+		vector<MyDB_PageHandle> pages;
+		for (int i = 0; i < 100; i++) {
+			pages.push_back(myMgr.getPage());
+			memset(pages[i].getBytes(), 'a', 64);
+			pages[i].wroteBytes();
+		}
+		if (myMgr.getPoolSize("sort") != 16) flag23 = false;
+
+		// and a big scan takes the idle sort pool's frames, but not the index's
+		cout << "scan..." << flush;
+		for (int i = 0; i < 200; i++)
+			myMgr.getPage(scanTable, i, true).getBytes();
+		if (myMgr.getPoolSize("sort") != 0 || myMgr.getPoolSize("default") != 48) flag23 = false;
+		size_t misses = myMgr.getNumMisses();
+		for (int i = 0; i < 16; i++)
+			myMgr.getPage(indexTable, i).getBytes();
+		if (myMgr.getNumMisses() != misses) flag23 = false;
+
+		MyDB_BufferStats stats = myMgr.getStats();
+		if (stats.byPool.size() != 3 || stats.byPool["index"].numFrames != 16 || stats.byPool["index"].maxFrames != 24) flag23 = false;
+		if (flag23) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	unlink("file12");
+	unlink("file13");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag23);
+
+	// the buffer can shrink and grow while it is in use
+	cout << "TEST 24..." << flush;
+	bool flag24 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_TablePtr table14 = make_shared <MyDB_Table>("table14", "file14");
+		MyDB_BufferManager myMgr(64, 128, "tempDSFSD", MyDB_ReplacementType::LRUReplacement, false, 512);
+		if (myMgr.getNumPages() != 128 || myMgr.getMaxPages() != 512 || myMgr.getNumShards() != 2) flag24 = false;
+
+		cout << "write pages..." << flush;
+		for (int i = 0; i < 128; i++) {
+			MyDB_PageHandle page = myMgr.getPage(table14, i);
+			memset(page.getBytes(), 'a' + i % 26, 64);
+			page.wroteBytes();
+		}
+		vector<MyDB_PageHandle> pinned;
+		for (int i = 0; i < 4; i++)
+			pinned.push_back(myMgr.getPinnedPage(table14, 124 + i));
+
+		// the dirty pages that go are written back, but the pinned ones stay until they are unpinned
+		cout << "shrink..." << flush;
+		if (myMgr.resize(16) != 16 || myMgr.getNumPages() != 16 || myMgr.getNumReservableFrames() != 14) flag24 = false;
+		if (myMgr.getPoolSize("default") > 20) flag24 = false;
+		pinned.clear();
+		if (myMgr.getPoolSize("default") > 16) flag24 = false;
+		for (int i = 0; i < 128; i++) {
+			char *bytes = (char *) myMgr.getPage(table14, i).getBytes();
+			if (bytes[0] != 'a' + i % 26 || bytes[63] != 'a' + i % 26) flag24 = false;
+		}
+		if (myMgr.getPoolSize("default") > 16) flag24 = false;
+
+		// growing only goes as far as the room that was set aside, and shrinking leaves a
+		// frame in each shard
+		cout << "grow..." << flush;
+		if (myMgr.resize(1000) != 512 || myMgr.getStats().numFrames != 512) flag24 = false;
+		for (int i = 0; i < 300; i++)
+			myMgr.getPage(table14, i).getBytes();
+		size_t misses = myMgr.getNumMisses();
+		for (int i = 0; i < 300; i++)
+			myMgr.getPage(table14, i).getBytes();
+		if (myMgr.getNumMisses() != misses || myMgr.getPoolSize("default") != 300) flag24 = false;
+		if (myMgr.resize(0) != 2) flag24 = false;
+		if (flag24) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	unlink("file14");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag24);
+
+	// page checksums are written with the pages, and catch a page that has been damaged
+	cout << "TEST 25..." << flush;
+	bool flag25 = true;
+	{
+		cout << "check crc32c..." << flush;
+		if (crc32c(0, "123456789", 9) != 0xE3069283 || crc32cSoftware(0, "123456789", 9) != 0xE3069283) flag25 = false;
+		vector<char> data(100000);
+		for (size_t i = 0; i < data.size(); i++)
+			data[i] = (char) (i * 7 + i / 13);
+		for (size_t len : {0, 5, 100, 800, 30000, 99999}) {
+			uint32_t whole = crc32c(0, &data[1], len);
+			if (whole != crc32cSoftware(0, &data[1], len) || whole != crc32c(crc32c(0, &data[1], len / 3), &data[1 + len / 3], len - len / 3))
+				flag25 = false;
+		}
+
+		cout << "write pages..." << flush;
+		MyDB_TablePtr table15 = make_shared <MyDB_Table>("table15", "file15");
+		{
+			MyDB_BufferManager myMgr(256, 16, "tempDSFSD");
+			myMgr.setPageChecksums(true);
+			for (int i = 0; i < 64; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table15, i);
+				memset(page.getBytes(), 0, 256);
+				memset(((char *) page.getBytes()) + 8, 'a' + i % 26, 248);
+				page.wroteBytes();
+			}
+		}
+
+		// every page on disk has a good checksum, in the bytes that the header leaves free
+		cout << "check file..." << flush;
+		int fd = open("file15", O_RDWR);
+		char page[256];
+		for (int i = 0; i < 64; i++) {
+			if (pread(fd, page, 256, i * 256) != 256 || storedChecksum(page) == 0 || !pageChecksumOK(page, 256) || page[8] != 'a' + i % 26)
+				flag25 = false;
+		}
+
+		// and damaging one byte of a page is caught
+		page[100] ^= 1;
+		if (pageChecksumOK(page, 256)) flag25 = false;
+		page[100] ^= 1;
+		close(fd);
+
+		// the pages read back fine
+		cout << "read pages..." << flush;
+		{
+			MyDB_BufferManager myMgr(256, 16, "tempDSFSD");
+			myMgr.setPageChecksums(true);
+			for (int i = 0; i < 64; i++) {
+				char *bytes = (char *) myMgr.getPage(table15, i).getBytes();
+				if (bytes[8] != 'a' + i % 26 || bytes[255] != 'a' + i % 26) flag25 = false;
+			}
+		}
+
+		// a page that is changed after the flusher has queued it up is still written with a
+		// checksum that matches what is written
+		cout << "flusher..." << flush;
+		{
+			MyDB_BufferManager myMgr(256, 16, "tempDSFSD");
+			myMgr.setPageChecksums(true);
+			myMgr.setCleanFraction(0.5);
+			for (int i = 0; i < 64; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table15, i);
+				char *bytes = (char *) page.getBytes();
+				memset(bytes + 8, 'A' + i % 26, 248);
+				page.wroteBytes();
+				if (i >= 4) {
+					char *older = (char *) myMgr.getPage(table15, i - 4).getBytes();
+					memset(older + 100, 'z', 50);
+				}
+			}
+		}
+		fd = open("file15", O_RDONLY);
+		for (int i = 0; i < 64; i++) {
+			if (pread(fd, page, 256, i * 256) != 256 || !pageChecksumOK(page, 256)) flag25 = false;
+		}
+		close(fd);
+		if (flag25) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	unlink("file15");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag25);
+
+	// the write-ahead log: recovery after a crash, and the log going to disk ahead of the pages
+	cout << "TEST 26..." << flush;
+	bool flag26 = true;
+	{
+		// what is on disk before the crash: pages 0 and 1, with page 1 torn
+		cout << "write table..." << flush;
+		MyDB_TablePtr table16 = make_shared <MyDB_Table>("table16", "file16");
+		vector<char> page0(256, 'x'), page1(256, 'y'), page2(256, 0);
+		unlink("file16");
+		int fd = open("file16", O_RDWR | O_CREAT, 0666);
+		if (pwrite(fd, page0.data(), 256, 0) != 256 || pwrite(fd, page1.data(), 256, 256) != 256) flag26 = false;
+		close(fd);
+
+		// log some changes: the first to each page logs it in full, and appends that follow on
+		// from each other go into one record
+		cout << "log..." << flush;
+		unlink("log16");
+		{
+			MyDB_LogManager myLog("log16", 256, 1024);
+			for (int i = 0; i < 10; i++) {
+				memset(&page0[16 + i * 20], 'a' + i, 20);
+				memset(&page0[8], 16 + (i + 1) * 20, 1);
+				myLog.logWrite(table16, 0, page0.data(), 16 + i * 20, 20, 16);
+			}
+			memset(&page1[100], 'z', 50);
+			myLog.logWrite(table16, 1, page1.data(), 100, 50);
+			myLog.logClear(table16, 2);
+			memset(&page2[0], 'h', 16);
+			myLog.logWrite(table16, 2, page2.data(), 0, 16);
+			myLog.logCatalog("table16.lastPage", "2");
+			myLog.commit();
+			if (myLog.getDurableLSN() != myLog.getLSN() || myLog.getNumFlushes() < 1) flag26 = false;
+		}
+
+		// the crash leaves a torn record at the end of the log
+		fd = open("log16", O_RDWR);
+		off_t logSize = lseek(fd, 0, SEEK_END);
+		LogRecordHeader torn = {1000, 1234, (uint32_t) MyDB_LogRecordType :: PageWrite};
+		if (pwrite(fd, &torn, sizeof(torn), logSize) != sizeof(torn)) flag26 = false;
+		close(fd);
+
+		cout << "recover..." << flush;
+		page1.assign(256, 'y');
+		memset(&page1[100], 'z', 50);
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catalog16");
+			MyDB_LogManager myLog("log16", 256);
+			if (myLog.recover(myCatalog, true) != 6) flag26 = false;
+			int lastPage;
+			if (!myCatalog->getInt("table16.lastPage", lastPage) || lastPage != 2) flag26 = false;
+		}
+
+		// the pages are as they were logged, with good checksums, and the log has started over
+		fd = open("file16", O_RDONLY);
+		char page[256];
+		for (int i = 0; i < 3; i++) {
+			vector<char> &expected = i == 0 ? page0 : (i == 1 ? page1 : page2);
+			if (pread(fd, page, 256, i * 256) != 256 || storedChecksum(page) == 0 || !pageChecksumOK(page, 256) ||
+				memcmp(page + 8, &expected[8], 248) != 0 || memcmp(page, &expected[0], 4) != 0)
+				flag26 = false;
+		}
+		close(fd);
+		struct stat info;
+		if (stat("log16", &info) != 0 || info.st_size > 100) flag26 = false;
+
+		// a page that was logged is not written until the log is durable up to its LSN
+		cout << "write ahead..." << flush;
+		{
+			MyDB_LogManagerPtr myLog = make_shared <MyDB_LogManager>("log16", 256);
+			MyDB_BufferManager myMgr(256, 4, "tempDSFSD");
+			myMgr.setLog(myLog);
+			MyDB_PageHandle page = myMgr.getPage(table16, 0);
+			memset(((char *) page.getBytes()) + 16, 'q', 16);
+			page.wroteBytes();
+			size_t lsn = myLog->logWrite(table16, 0, page.getBytes(), 16, 16);
+			page.setLSN(lsn);
+			if (myLog->getDurableLSN() >= lsn) flag26 = false;
+			for (int i = 1; i < 16; i++)
+				myMgr.getPage(table16, i).getBytes();
+			if (myLog->getDurableLSN() < lsn) flag26 = false;
+		}
+		if (flag26) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	unlink("file16");
+	unlink("log16");
+	unlink("catalog16");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag26);
+
+	// under LRU, a page that is used again outlives pages that are colder than it, even when
+	// the buffer has room to grow or its pool only has part of the buffer
+	cout << "TEST 27..." << flush;
+	bool flag27 = true;
+	{
+		MyDB_TablePtr table17 = make_shared <MyDB_Table>("table17", "file17");
+		{
+			cout << "room to grow..." << flush;
+			MyDB_BufferManager myMgr(64, 8, "tempDSFSD", MyDB_ReplacementType::LRUReplacement, false, 64);
+			for (int i = 0; i < 8; i++)
+				myMgr.getPage(table17, i).getBytes();
+			myMgr.getPage(table17, 0).getBytes();
+			for (int i = 8; i < 15; i++)
+				myMgr.getPage(table17, i).getBytes();
+			size_t misses = myMgr.getNumMisses();
+			myMgr.getPage(table17, 0).getBytes();
+			if (myMgr.getNumMisses() != misses) flag27 = false;
+		}
+		{
+			cout << "small pool..." << flush;
+			MyDB_BufferManager myMgr(64, 16, "tempDSFSD", MyDB_ReplacementType::LRUReplacement);
+			if (!myMgr.createPool("small", 0, 4) || !myMgr.setPool(table17, "small")) flag27 = false;
+			for (int i = 0; i < 4; i++)
+				myMgr.getPage(table17, i).getBytes();
+			myMgr.getPage(table17, 0).getBytes();
+			for (int i = 4; i < 7; i++)
+				myMgr.getPage(table17, i).getBytes();
+			size_t misses = myMgr.getNumMisses();
+			myMgr.getPage(table17, 0).getBytes();
+			if (myMgr.getNumMisses() != misses || myMgr.getPoolSize("small") > 4) flag27 = false;
+		}
+		if (flag27) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	unlink("file17");
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag27);
 }
 
 #endif
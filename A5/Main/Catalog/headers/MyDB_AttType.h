@@ -24,6 +24,10 @@ public:
 	virtual MyDB_AttValPtr createAttMax () = 0;
 	virtual string toString () = 0;
 	virtual bool isBool () = 0;
+
+	// the number of bytes that a value of this type takes up in the fixed-width row format
+	// (see MyDB_Schema :: isFixedWidth), or zero if the type has no fixed width
+	virtual size_t getFixedSize () = 0;
 };
 
 class MyDB_IntAttType : public MyDB_AttType {
@@ -52,6 +56,10 @@ public:
 		return false;
 	}
 
+	size_t getFixedSize () {
+		return sizeof (int);
+	}
+
 	MyDB_AttValPtr createAtt () {
 		return make_shared <MyDB_IntAttVal> ();
 	}	
@@ -90,6 +98,10 @@ public:
 		return false;
 	}
 
+	size_t getFixedSize () {
+		return sizeof (double);
+	}
+
 	MyDB_AttValPtr createAtt () {
 		return make_shared <MyDB_DoubleAttVal> ();
 	}	
@@ -123,6 +135,10 @@ public:
 		return false;
 	}
 
+	size_t getFixedSize () {
+		return 0;
+	}
+
 	string toString () {
 		return "string";
 	}
@@ -160,6 +176,10 @@ public:
 		return true;
 	}
 
+	size_t getFixedSize () {
+		return sizeof (char);
+	}
+
 	string toString () {
 		return "bool";
 	}
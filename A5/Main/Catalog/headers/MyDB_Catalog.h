@@ -14,6 +14,9 @@ using namespace std;
 class MyDB_Catalog;
 typedef shared_ptr <MyDB_Catalog> MyDB_CatalogPtr;
 
+class MyDB_LogManager;
+typedef shared_ptr <MyDB_LogManager> MyDB_LogManagerPtr;
+
 // this encapsulates a simple little key-value store
 class MyDB_Catalog {
 
@@ -54,8 +57,18 @@ public:
 	// saves any updates to the catalog
 	void save ();
 
+	// from now on, every (key, value) pair that is put into the catalog is also written to
+	// the given write-ahead log, so that it survives a crash (see MyDB_LogManager.h)
+	void setLog (MyDB_LogManagerPtr log);
+
 private:
 
+	// puts the pair into the map, and into the log
+	void put (string key, string value);
+
+	// the write-ahead log, if there is one
+	MyDB_LogManagerPtr log;
+
 	// the name of the catalog file
 	string fName;
 
@@ -1,3 +1,69 @@
 
+#ifndef PAGE_TYPE_H
+#define PAGE_TYPE_H
+
+#include <cstddef>
+#include <cstdint>
+
 // this lists all of the different page types
-enum MyDB_PageType {RegularPage, DirectoryPage};
+enum MyDB_PageType {RegularPage, DirectoryPage, SlottedPage, PaxPage};
+
+// every page starts with the same header, two words long: the page type (in the first four bytes
+// of the first word, with the rest of that word holding the buffer manager's checksum), and the
+// number of bytes used on the page, header included
+#define PAGE_HEADER_BYTES (2 * sizeof (size_t))
+
+// a SlottedPage has the same header as a RegularPage, and its records are packed in after the
+// header in the order that they were appended, but it also has a slot directory at the end of
+// the page, so that record k can be found without reading the k - 1 records before it.  The
+// last sizeof (size_t) bytes of the page hold the number of slots, and going backwards from
+// there are the slots, each of which is the offset of a record on the page.  The slots are in
+// the order that the records are iterated in (which is not where they are on the page, once
+// the page has been sorted in place)
+
+// the number of slots on a slotted page
+inline size_t &slottedPageNumSlots (void *page, size_t pageSize) {
+	return *((size_t *) (((char *) page) + pageSize - sizeof (size_t)));
+}
+
+// slot k of a slotted page
+inline uint32_t &slottedPageSlot (void *page, size_t pageSize, size_t k) {
+	return ((uint32_t *) (((char *) page) + pageSize - sizeof (size_t)))[-1 - (long) k];
+}
+
+// a PaxPage stores its records column by column.  After the usual header comes a PaxHeader,
+// then a PaxColumn for each attribute, and then the minipages, one for each attribute, which
+// hold the values of that attribute for all of the records on the page, in order.  A column
+// whose width is not zero holds just the bytes of its values (see MyDB_AttType :: getFixedSize);
+// the values in any other column are serialized as they are in a record, with their lengths.
+// Each minipage runs up to the start of the next one (or the end of the page).  They are laid
+// out when the first record is appended, in proportion to the sizes of its values, and they
+// are laid out again, in proportion to what is in them, whenever one of them fills up
+struct PaxHeader {
+	uint32_t numRecords;
+	uint32_t numColumns;	// zero until the first record is appended
+};
+
+struct PaxColumn {
+	uint32_t start;		// where the minipage starts on the page
+	uint32_t used;		// the number of bytes of values in it
+	uint32_t width;		// the size of each value, or zero if the values have their lengths
+};
+
+// the PaxHeader and the columns of a PaxPage
+inline PaxHeader &paxPageHeader (void *page) {
+	return *((PaxHeader *) (((char *) page) + PAGE_HEADER_BYTES));
+}
+
+inline PaxColumn *paxPageColumns (void *page) {
+	return (PaxColumn *) (((char *) page) + PAGE_HEADER_BYTES + sizeof (PaxHeader));
+}
+
+// the number of bytes that the values of column c of a PaxPage have room for
+inline size_t paxColumnCapacity (void *page, size_t pageSize, size_t c) {
+	PaxColumn *columns = paxPageColumns (page);
+	size_t end = c + 1 < paxPageHeader (page).numColumns ? columns[c + 1].start : pageSize;
+	return end - columns[c].start;
+}
+
+#endif
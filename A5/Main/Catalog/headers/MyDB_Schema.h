@@ -24,6 +24,9 @@ public:
 	// get the list of all of the attributes... the pair is the name and the type
 	vector <pair <string, MyDB_AttTypePtr>> &getAtts ();
 
+	// constructs an empty schema
+	MyDB_Schema ();
+
 	// append another attribute to the schema
 	void appendAtt (pair <string, MyDB_AttTypePtr> addAtt);
 
@@ -33,6 +36,18 @@ public:
 	// add to the catalog
 	void putInCatalog (string TableName, MyDB_CatalogPtr toMe);
 
+	// true if records with this schema are stored in the fixed-width row format, which is used
+	// whenever every attribute is an int, a double or a bool: each attribute is stored as its
+	// raw bytes, at an offset that is the same in every record, and there are no lengths at
+	// all.  A schema that is loaded from a catalog that does not say which format its table is
+	// in (one written before there was a fixed-width format) uses the variable-width format
+	bool isFixedWidth ();
+
+	// for the fixed-width format: the number of bytes in each record, and the offset of each
+	// attribute in the record
+	size_t getFixedSize ();
+	vector <size_t> &getFixedOffsets ();
+
 	// to print out the the screen
 	friend std::ostream& operator<<(std::ostream& os, const MyDB_Schema printMe);
 	friend std::ostream& operator<<(std::ostream& os, const MyDB_SchemaPtr printMe);
@@ -45,6 +60,14 @@ private:
 	// this is a list, in order, of the attributes in the schema
 	// the string is the name of the attribute, and we also know the types
 	vector <pair <string, MyDB_AttTypePtr>> allAtts;
+
+	// works out whether the attributes can use the fixed-width format, and if so, where each one goes
+	void computeLayout ();
+
+	// the fixed-width layout, if fixedWidth is true
+	bool fixedWidth;
+	size_t fixedSize;
+	vector <size_t> fixedOffsets;
 };
 
 #endif
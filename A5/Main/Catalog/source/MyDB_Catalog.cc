@@ -3,6 +3,8 @@
 #define CATALOG_C
 
 #include "MyDB_Catalog.h"
+#include <cstdio>
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -11,12 +13,24 @@
 #include "MyDB_AttType.h"
 #include "MyDB_AttVal.h"
 #include "MyDB_Catalog.h"
+#include "MyDB_LogManager.h"
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
+#include <unistd.h>
 
-void MyDB_Catalog :: putString (string key, string value) {
+void MyDB_Catalog :: setLog (MyDB_LogManagerPtr logIn) {
+	log = logIn;
+}
+
+void MyDB_Catalog :: put (string key, string value) {
 	myData [key] = value;
+	if (log != nullptr)
+		log->logCatalog (key, value);
+}
+
+void MyDB_Catalog :: putString (string key, string value) {
+	put (key, value);
 }
 
 void MyDB_Catalog :: putStringList (string key, vector <string> value) {
@@ -24,13 +38,13 @@ void MyDB_Catalog :: putStringList (string key, vector <string> value) {
 	for (string s : value) {
 		res = res + s + "#";
 	}
-	myData [key] = res;
+	put (key, res);
 }
 
 void MyDB_Catalog :: putInt (string key, int value) {
 	ostringstream convert;
 	convert << value;
-	myData [key] = convert.str ();
+	put (key, convert.str ());
 }
 
 bool MyDB_Catalog :: getStringList (string key, vector <string> &returnVal) {
@@ -116,12 +130,23 @@ MyDB_Catalog :: ~MyDB_Catalog () {
 
 void MyDB_Catalog :: save () {
 
-	ofstream myFile (fName, ofstream::out | ofstream::trunc);
-	if (myFile.is_open()) {
-		for (auto const &ent : myData) {
-			myFile << "|" << ent.first << "|" << ent.second << "|\n";
-		}
+	// the new contents go into a file of their own, which then replaces the old one, so that
+	// a crash leaves one or the other
+	string tempName = fName + ".tmp";
+	ofstream myFile (tempName, ofstream::out | ofstream::trunc);
+	if (!myFile.is_open())
+		return;
+	for (auto const &ent : myData) {
+		myFile << "|" << ent.first << "|" << ent.second << "|\n";
+	}
+	myFile.close ();
+
+	int fd = open (tempName.c_str (), O_RDONLY);
+	if (fd != -1) {
+		fsync (fd);
+		close (fd);
 	}
+	rename (tempName.c_str (), fName.c_str ());
 }
 
 #endif
@@ -68,10 +68,17 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 			exit (1);
 		}
 	}
+	computeLayout ();
+
+	// a table that was put in the catalog without a row format was written in the variable-width one
+	string rowFormat;
+	if (!catalog->getString (tableName + ".rowFormat", rowFormat) || rowFormat != "fixed")
+		fixedWidth = false;
 }
 
 void MyDB_Schema :: appendAtt (pair <string, MyDB_AttTypePtr> addAtt) {
 	allAtts.push_back (addAtt);
+	computeLayout ();
 }
 
 void MyDB_Schema :: putInCatalog (string tableName, MyDB_CatalogPtr catalog) {
@@ -80,6 +87,36 @@ void MyDB_Schema :: putInCatalog (string tableName, MyDB_CatalogPtr catalog) {
 	for (auto entry : allAtts) {
 		addAtt (tableName, entry, catalog);
 	}	
+	catalog->putString (tableName + ".rowFormat", fixedWidth ? "fixed" : "variable");
+}
+
+void MyDB_Schema :: computeLayout () {
+	fixedWidth = !allAtts.empty ();
+	fixedSize = 0;
+	fixedOffsets.clear ();
+	for (auto &entry : allAtts) {
+		size_t attSize = entry.second->getFixedSize ();
+		if (attSize == 0)
+			fixedWidth = false;
+		fixedOffsets.push_back (fixedSize);
+		fixedSize += attSize;
+	}
+}
+
+bool MyDB_Schema :: isFixedWidth () {
+	return fixedWidth;
+}
+
+size_t MyDB_Schema :: getFixedSize () {
+	return fixedSize;
+}
+
+vector <size_t> &MyDB_Schema :: getFixedOffsets () {
+	return fixedOffsets;
+}
+
+MyDB_Schema :: MyDB_Schema () {
+	computeLayout ();
 }
 
 vector <pair <string, MyDB_AttTypePtr>> &MyDB_Schema :: getAtts () {
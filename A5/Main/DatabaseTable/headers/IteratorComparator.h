@@ -30,9 +30,10 @@ public:
 
 	IteratorComparator () {}
 
+	// the records are only compared, so they are views of the iterators' pages when they can be
 	bool operator() (const MyDB_RecordIteratorAltPtr leftIter, const MyDB_RecordIteratorAltPtr rightIter) const {
-		leftIter->getCurrent (lhs);
-		rightIter->getCurrent (rhs);
+		leftIter->getCurrentView (lhs);
+		rightIter->getCurrentView (rhs);
 		return !comparator ();
 	}
 
@@ -27,6 +27,7 @@ public:
 
         // load the current record into the parameter
         void getCurrent (MyDB_RecordPtr intoMe) override;
+        void getCurrentView (MyDB_RecordPtr intoMe) override;
 
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
@@ -39,8 +40,10 @@ public:
         // be called until after getCurrent () has been called
         bool advance () override;
 
-	// destructor and contructor
-	MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
+	// destructor and contructor... if discardAsRead is true, each page is marked as
+	// discardable once the iterator has moved past it.  The page that the iterator is on is
+	// kept pinned (if there is room to pin it), so that getCurrentView does not copy
+	MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, bool discardAsRead = false);
 	~MyDB_PageListIteratorAlt ();
 
 private:
@@ -48,6 +51,13 @@ private:
 	MyDB_RecordIteratorAltPtr myIter;
 	vector <MyDB_PageReaderWriter> forUs;
 	int curPage;
+	bool discardAsRead;
+
+	// true if the page that we are on is pinned
+	bool pinned;
+
+	// moves on to the page curPage
+	void startPage ();
 };
 
 #endif
@@ -14,6 +14,7 @@
 #define PAGE_RW_H
 
 #include <memory>
+#include <vector>
 #include "MyDB_PageType.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
@@ -30,19 +31,32 @@ public:
 	// constructor for a page in the same file as the parent
 	MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage);
 
-	// constructor for a page that can be pinned, if desired
+	// constructor for a page that can be pinned, if desired (if the buffer is so full of pinned
+	// pages that it cannot be, it is left unpinned)
 	MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage);
 
+	// constructor for a page in the same file as the parent that is being read as
+	// part of a sequential scan, if sequentialScan is true
+	MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage, bool sequentialScan);
+
 	// constructor for an anonymous page
 	MyDB_PageReaderWriter (MyDB_BufferManager &parent);
 
-	// constructor for an anonymous page that can be pinned, if desired
+	// constructor for an anonymous page that can be pinned, if desired (as above)
 	MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent);
 
+	// constructor for an anonymous page in a temp file slot reserved with
+	// MyDB_BufferManager :: reserveTempPages
+	MyDB_PageReaderWriter (MyDB_BufferManager &parent, size_t reservedSlot);
+
 	// empties out the contents of this page, so that it has no records in it
 	// the type of the page is set to MyDB_PageType :: RegularPage
 	void clear ();	
 
+	// like the above, except that the page is given the type toMe... a SlottedPage is set up
+	// with an empty slot directory, and a PaxPage with no columns (see MyDB_PageType.h)
+	void clear (MyDB_PageType toMe);
+
 	// return an itrator over this page... each time returnVal->next () is
 	// called, the resulting record will be placed into the record pointed to
 	// by iterateIntoMe
@@ -52,8 +66,18 @@ public:
 	// iterator that has the alternate getCurrent ()/advance () interface
 	MyDB_RecordIteratorAltPtr getIteratorAlt ();
 
+	// like the above, except that only the attributes whose indexes are in whichAtts are read
+	// into the record by getCurrent ()... on a PaxPage, the other columns are never touched, and
+	// getCurrentPointer () returns nullptr.  On any other kind of page, this is the same as the above
+	MyDB_RecordIteratorAltPtr getIteratorAlt (vector <int> whichAtts);
+
+	// like getIteratorAlt (), for a page that the caller has pinned, and keeps pinned for as
+	// long as the iterator and the records that it fills in are used: a record that has a
+	// projection (see MyDB_Record :: setProjection) is pointed right at the page, not copied
+	MyDB_RecordIteratorAltPtr getPinnedIteratorAlt ();
+
 	// gets an instance of an alternatie iterator over a list of pages
-	friend MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
+	friend MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, bool discardAsRead);
 
 	// appends a record to this page... return false is the append fails because
 	// there is not enough space on the page; otherwise, return true
@@ -70,14 +94,32 @@ public:
 
 	// sets the type of the page
 	void setType (MyDB_PageType toMe);
+
+	// the rest of these are for a SlottedPage: the number of records on it (this one also works
+	// on a PaxPage), the address of record k (which stays good as long as the page is pinned),
+	// and record k itself
+	size_t getNumRecords ();
+	void *getRecordPointer (size_t k);
+	void getRecord (size_t k, MyDB_RecordPtr intoMe);
+
+	// binary searches on a SlottedPage whose records are sorted, using a lambda that checks
+	// whether the record pointed to by lhs is less than the one pointed to by rhs, as for sort.
+	// lowerBound returns the first slot whose record is not less than the record in rhs (the
+	// records on the page are loaded into lhs), and upperBound returns the first slot whose
+	// record is greater than the record in lhs (the records on the page are loaded into rhs);
+	// either returns getNumRecords () if there is no such slot
+	size_t lowerBound (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+	size_t upperBound (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 	
 	// sorts the contents of the page... the boolean lambda that is sent into
 	// this function must check to see if the contents of the record pointed to
 	// by lhs are less than the contens of the record pointed to by rhs... typically,
-	// this lambda would have been created via a call to buildRecordComparator
+	// this lambda would have been created via a call to buildRecordComparator... the sorted
+	// page is of the same type as this one.  A PaxPage cannot be sorted
 	MyDB_PageReaderWriterPtr sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
-	// like the above, except that the sorting is done in place, on the page
+	// like the above, except that the sorting is done in place, on the page... on a SlottedPage,
+	// only the slot directory is put in order, and the records themselves are not moved
 	void sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
 	// returns the page size
@@ -86,6 +128,22 @@ public:
 	// returns the actual bytes
 	void *getBytes ();
 
+	// pins the page, so that its bytes stay where they are (even if other threads are using
+	// the buffer manager) until a matching call to unpin; returns false if the page could not
+	// be pinned because the buffer is full of pinned pages
+	bool pin ();
+
+	// undoes one call to pin
+	void unpin ();
+
+	// a hint that this anonymous page will not be read again, so that if it is evicted, the
+	// buffer manager drops it instead of writing it to the temp file
+	void setDiscardable ();
+
+	// tells the buffer manager that a change to this page was logged with the given LSN (see
+	// MyDB_PageHandle :: setLSN)
+	void setLSN (size_t lsn);
+
 private:
 
 	// this is the page that we are messing with
@@ -93,9 +151,27 @@ private:
 	
 	// this is our buffer manager
 	size_t pageSize;
+
+	// where appendPax serializes records
+	vector <char> paxScratch;
+
+	// the addresses of the records on the page, in order, if the page's bytes are at bytes;
+	// useMe is used to step over the records on a page that is not slotted (unless the records
+	// are in the fixed-width format)
+	vector <void *> getPositions (void *bytes, MyDB_RecordPtr useMe);
+
+	// appends a record to a PaxPage, splitting it up into its columns; returns where the value of
+	// the record's first attribute was written, or nullptr if the record does not fit
+	void *appendPax (MyDB_RecordPtr appendMe);
+
+	// lays out the minipages of a PaxPage again, so that column c has room for adding[c] more
+	// bytes; returns false (leaving the page as it was) if they do not all fit on the page
+	bool layOutPax (vector <size_t> &adding);
 };
 
-// gets an instance of an alternatie iterator over a list of pages
-MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
+// gets an instance of an alternatie iterator over a list of pages... if discardAsRead is true,
+// the pages are anonymous pages that are only going to be read once, by this iterator, and each
+// one is marked as discardable once the iterator is done with it
+MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, bool discardAsRead = false);
 
 #endif
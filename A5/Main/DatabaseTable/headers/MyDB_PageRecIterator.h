@@ -34,8 +34,8 @@ public:
         // that the record is located on has not been swapped out
         void *getCurrentPointer () override;
 
-	// destructor and contructor
-	MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn); 
+	// destructor and contructor... a SlottedPage is iterated in the order of its slots
+	MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn, size_t pageSizeIn); 
 	~MyDB_PageRecIterator ();
 
 private:
@@ -43,7 +43,12 @@ private:
 	int bytesConsumed;
 	MyDB_PageHandle myPage;
 	MyDB_RecordPtr myRec;
-	
+
+	// if the page is a SlottedPage, the next slot to read
+	bool slotted;
+	size_t nextSlot;
+	size_t pageSize;
+
 };
 
 #endif
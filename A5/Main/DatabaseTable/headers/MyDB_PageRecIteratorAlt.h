@@ -24,6 +24,9 @@ public:
         // load the current record into the parameter
         void getCurrent (MyDB_RecordPtr intoMe) override;
 
+	// a view of the current record, if the page is kept pinned
+	void getCurrentView (MyDB_RecordPtr intoMe) override;
+
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
@@ -35,8 +38,11 @@ public:
         // be called until after getCurrent () has been called
         bool advance () override;
 
-	// destructor and contructor
-	MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn); 
+	// destructor and contructor... a SlottedPage is iterated in the order of its slots.  If
+	// pinnedIn is true, whoever made the iterator keeps the page pinned for as long as it and
+	// the records that it fills in are used, so a record with a projection (see
+	// MyDB_Record :: setProjection) is pointed right at the page instead of copied
+	MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn, bool pinnedIn = false); 
 	~MyDB_PageRecIteratorAlt ();
 
 private:
@@ -44,6 +50,14 @@ private:
 	int bytesConsumed;
 	int nextRecSize;
 	MyDB_PageHandle myPage;
+
+	// if the page is a SlottedPage, the slot that we are at
+	bool slotted;
+	long curSlot;
+	size_t pageSize;
+
+	// true if the page is kept pinned by whoever made the iterator
+	bool pinned;
 };
 
 #endif
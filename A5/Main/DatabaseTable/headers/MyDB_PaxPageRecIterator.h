@@ -0,0 +1,37 @@
+
+#ifndef PAX_PAGE_REC_ITER_H
+#define PAX_PAGE_REC_ITER_H
+
+#include "MyDB_PaxPageRecIteratorAlt.h"
+#include "MyDB_RecordIterator.h"
+
+// the getNext ()/hasNext () interface to the records on a PaxPage, with all of the columns
+// read; see MyDB_PaxPageRecIteratorAlt
+class MyDB_PaxPageRecIterator : public MyDB_RecordIterator {
+
+public:
+
+	// put the contents of the next record on the page into the iterator record
+	void getNext () override;
+
+	// return true iff there is another record on the page
+	bool hasNext () override;
+
+	// a record on a PaxPage is not in one place, so this always returns nullptr
+	void *getCurrentPointer () override;
+
+	// destructor and contructor
+	MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn, int numAtts);
+	~MyDB_PaxPageRecIterator ();
+
+private:
+
+	MyDB_PaxPageRecIteratorAlt myIter;
+	MyDB_RecordPtr myRec;
+
+	// true if myIter has been advanced to the next record, and there is one
+	bool advanced;
+	bool haveNext;
+};
+
+#endif
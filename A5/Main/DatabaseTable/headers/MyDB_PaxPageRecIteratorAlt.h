@@ -0,0 +1,50 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_H
+#define PAX_PAGE_REC_ITER_ALT_H
+
+#include <vector>
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+
+using namespace std;
+
+// iterates over the records on a PaxPage (see MyDB_PageType.h), reading only the columns that
+// it is asked for.  The attributes that are read are pointed right at the page's bytes, so the
+// page is kept pinned (if there is room to pin it) for as long as the iterator is around, and
+// the record should not be used once the iterator is gone
+class MyDB_PaxPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+	// loads the attributes that the iterator reads into the parameter... the record's other
+	// attributes are left as they are
+	void getCurrent (MyDB_RecordPtr intoMe) override;
+
+	// a record on a PaxPage is not in one place, so this always returns nullptr
+	void *getCurrentPointer () override;
+
+	// advance to the next record... returns true if there is a next record, and
+	// false if there are no more records to iterate over.  Unlike on other pages,
+	// this can be called without getCurrent () having been called
+	bool advance () override;
+
+	// iterates over the page, reading the attributes whose indexes are in whichAtts
+	MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, vector <int> whichAtts);
+	~MyDB_PaxPageRecIteratorAlt ();
+
+private:
+
+	MyDB_PageHandle myPage;
+	bool pinned;
+
+	// the attributes that are read, and where the current value of each one is on the page
+	vector <int> whichAtts;
+	vector <size_t> positions;
+
+	// the record that we are on (-1 before the first call to advance), and the number of them
+	long curRec;
+	long numRecords;
+};
+
+#endif
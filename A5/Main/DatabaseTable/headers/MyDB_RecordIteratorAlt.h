@@ -20,6 +20,13 @@ public:
 	// load the current record into the parameter
 	virtual void getCurrent (MyDB_RecordPtr intoMe) = 0;
 
+	// like getCurrent, except that if the iterator keeps the page that it is on pinned, the
+	// record is made a view of the page (see MyDB_Record :: viewBinary) instead of a copy... it
+	// is only good until the next call to advance (), so this is for comparing records, say
+	virtual void getCurrentView (MyDB_RecordPtr intoMe) {
+		getCurrent (intoMe);
+	}
+
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
@@ -31,6 +31,7 @@ public:
 
         // load the current record into the parameter
         void getCurrent (MyDB_RecordPtr intoMe) override;
+        void getCurrentView (MyDB_RecordPtr intoMe) override;
 
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
@@ -52,10 +53,15 @@ public:
         	return pq;
 	}
 
+	// keeps the frame reservation that the runs were built with until the merge is done
+	void holdFrames (MyDB_FrameReservationPtr frames);
+
 	~MyDB_RunQueueIteratorAlt ();
 
 private:
 
+	MyDB_FrameReservationPtr frames;
+
 	priority_queue <MyDB_RecordIteratorAltPtr, vector <MyDB_RecordIteratorAltPtr>, IteratorComparator> pq;
 	bool firstTime;
 };
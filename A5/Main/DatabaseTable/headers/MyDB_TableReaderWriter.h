@@ -32,9 +32,18 @@ class MyDB_TableReaderWriter {
 
 public:
 
-	// create a table reader/writer
+	// create a table reader/writer... if the buffer manager has a write-ahead log (see
+	// MyDB_BufferManager :: setLog) and this is a heap table, every record appended to the
+	// table, every page added to it, and its last page number, are logged.  Nothing else that
+	// writes to the table's pages is, so nothing else should write to them.  The pages of a table
+	// whose file type is "pax" are PaxPages (see MyDB_PageType.h), and they are not logged
 	MyDB_TableReaderWriter (MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
 
+	// like the above, but if readOnly is true, the table's file is mapped into memory (see
+	// MyDB_BufferManager::mapReadOnly), so that reading a page never copies it... the table
+	// must not be written through this object, or any other
+	MyDB_TableReaderWriter (MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer, bool readOnly);
+
 	// gets an empty record from this table
 	MyDB_RecordPtr getEmptyRecord ();
 
@@ -47,7 +56,10 @@ public:
 	MyDB_RecordIteratorPtr getIterator (MyDB_RecordPtr iterateIntoMe);
 
         // gets an instance of an alternate iterator over the table... this is an
-        // iterator that has the alternate getCurrent ()/advance () interface
+        // iterator that has the alternate getCurrent ()/advance () interface.  The page
+        // that it is on is kept pinned, so a record with a projection (see
+        // MyDB_Record :: setProjection) is pointed right at the page, and is only good
+        // until the iterator moves on to the next page
         MyDB_RecordIteratorAltPtr getIteratorAlt ();
 
 	// gets an instance of an alternate iterator over the page; this iterator
@@ -55,6 +67,11 @@ public:
 	// highPage inclusive
 	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
 
+	// gets an alternate iterator over the table that only reads the attributes whose indexes
+	// are in whichAtts into the record (see MyDB_PageReaderWriter :: getIteratorAlt); on a
+	// "pax" table, the other attributes are never read off of the pages at all
+	MyDB_RecordIteratorAltPtr getIteratorAlt (vector <int> whichAtts);
+
 	// load a text file into this table... this returns a pair where the first
 	// entry is a list of (approximate) distinct value counts for each of the
 	// attributes in the table, and the second entry is the number of tuples that
@@ -70,6 +87,10 @@ public:
 	// access the i^th page in this file... getting a pinned version of the page
 	MyDB_PageReaderWriter getPinned (size_t i);
 
+	// access the i^th page in this file as part of a sequential scan, so that the
+	// buffer manager gets rid of it before pages that are being reused
+	MyDB_PageReaderWriter getForScan (size_t i);
+
 	// access the last page in the file
 	MyDB_PageReaderWriter last ();
 
@@ -87,11 +108,17 @@ public:
 
 private:
 
+	// empties out the page that the table has just been extended to, and makes it the last page
+	void clearLastPage ();
+
 	friend class MyDB_PageReaderWriter;
 	friend class MyDB_BPlusTreeReaderWriter;
 	MyDB_TablePtr forMe;
 	MyDB_BufferManagerPtr myBuffer;
 	shared_ptr <MyDB_PageReaderWriter> lastPage;
+
+	// the write-ahead log that changes to the table go into (nullptr if they are not logged)
+	MyDB_LogManagerPtr log;
 	
 };
 
@@ -13,17 +13,22 @@
 #ifndef TABLE_REC_ITER_ALT_H
 #define TABLE_REC_ITER_ALT_H
 
+#include "MyDB_PageReaderWriter.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_Record.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_Table.h"
 
+// the number of pages that a scan tries to keep on their way in ahead of the page it is on
+#define READ_AHEAD_PAGES 8
+
 class MyDB_TableRecIteratorAlt : public MyDB_RecordIteratorAlt {
 
 public:
 
         // load the current record into the parameter
         void getCurrent (MyDB_RecordPtr intoMe) override;
+        void getCurrentView (MyDB_RecordPtr intoMe) override;
 
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
@@ -41,11 +46,36 @@ public:
 	~MyDB_TableRecIteratorAlt ();
 	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, int lowPage, int highPage);
 
+	// iterates over the whole table, only reading the attributes whose indexes are in whichAtts
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, vector <int> whichAtts);
+
 private:
 
 	MyDB_RecordIteratorAltPtr myIter;
 	int curPage;
 	int highPage;	
+
+	// the page that we are on, which is kept pinned (if there was room to pin it) so that
+	// its bytes stay put while we are iterating over it
+	MyDB_PageReaderWriterPtr scanPage;
+	bool pinned;
+
+	// the type of that page, so that it does not have to be looked up for every record
+	MyDB_PageType scanPageType;
+
+	// moves on to the page curPage
+	void startPage ();
+
+	// the attributes that are read, if not all of them are
+	bool projected;
+	vector <int> whichAtts;
+
+	// the first page that has not been prefetched yet
+	int readAheadTo;
+
+	// starts the reads for the pages after curPage, if it is running short
+	void readAhead ();
+
 	MyDB_TableReaderWriter &myParent;
 	MyDB_TablePtr myTable;
 };
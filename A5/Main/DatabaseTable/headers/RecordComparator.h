@@ -17,9 +17,11 @@ public:
 		rhs = rhsIn;
 	}
 
+	// the records that are sorted stay put while they are sorted, so the ones that are compared
+	// are just views of them
 	bool operator () (void *lhsPtr, void *rhsPtr) {
-		lhs->fromBinary (lhsPtr);
-		rhs->fromBinary (rhsPtr);
+		lhs->viewBinary (lhsPtr);
+		rhs->viewBinary (rhsPtr);
 		return comparator ();	
 	}
 
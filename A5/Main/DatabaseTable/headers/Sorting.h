@@ -8,15 +8,18 @@
 #include "IteratorComparator.h"
 
 // performs a TPMMS of the table sortMe.  The results are written to sortIntoMe.  The run 
-// size for the first phase of the TPMMS is given by runSize.  Comparisons are performed 
-// using comparator, lhs, rhs
+// size for the first phase of the TPMMS is given by runSize (see below).  Comparisons are
+// performed using comparator, lhs, rhs
 void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
         function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
 // Accepts the input file sortMe, and then uses the specified comparator over the records lhs 
 // and rhs to sort the file into a set of sorted runs of length at most runSize.  It then
 // constructs an iterator over those runs, that can be used to scan the data in sorted order
-// in the input file.
+// in the input file.  The sort reserves runSize + 2 frames from the buffer manager (for the
+// pages of the run, the input page and the output page), and if fewer are granted, because
+// other operators have reserved the rest, the runs are made shorter to fit; the frames are
+// held until the iterator is destroyed
 MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
         function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
@@ -28,8 +31,12 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 // helper function.  Gets two iterators, leftIter and rightIter.  It is assumed that these are iterators over
 // sorted lists of records.  This function then merges all of those records into a list of anonymous pages,
 // and returns the list of anonymous pages to the caller.  The resulting list of anonymous pages is sorted.
-// Comparisons are performed using comparator, lhs, rhs
+// Comparisons are performed using comparator, lhs, rhs.  If maxPages is given (usually the number of pages
+// in the two inputs), that many slots are reserved up front in one contiguous piece of the temp file, so
+// that the run is written and read back sequentially.  Repacking the merged records can take more pages
+// than the inputs did; any pages past the reserved ones go wherever the temp space puts them
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
-        MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+        MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs,
+	size_t maxPages = 0);
 
 #endif
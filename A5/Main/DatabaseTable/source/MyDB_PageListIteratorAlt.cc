@@ -20,29 +20,52 @@ void MyDB_PageListIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
 	myIter->getCurrent (intoMe);
 }
 
+void MyDB_PageListIteratorAlt :: getCurrentView (MyDB_RecordPtr intoMe) {
+	myIter->getCurrentView (intoMe);
+}
+
 bool MyDB_PageListIteratorAlt :: advance () {
 
 	if (myIter->advance ())
 		return true;
 
+	// we are done with this page
+	if (discardAsRead)
+		forUs[curPage].setDiscardable ();
+
 	if (curPage == forUs.size () - 1)
 		return false;
 
 	curPage++;
-	myIter = forUs[curPage].getIteratorAlt ();
+	startPage ();
 	return advance ();
 }
 
+void MyDB_PageListIteratorAlt :: startPage () {
+
+	// let go of the last page first, so that its frame can be reused
+	if (pinned)
+		forUs[curPage - 1].unpin ();
+
+	pinned = forUs[curPage].pin ();
+	myIter = pinned ? forUs[curPage].getPinnedIteratorAlt () : forUs[curPage].getIteratorAlt ();
+}
+
 void *MyDB_PageListIteratorAlt :: getCurrentPointer () {
 	return myIter->getCurrentPointer ();
 }
 
-MyDB_PageListIteratorAlt :: MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUsIn) {
+MyDB_PageListIteratorAlt :: MyDB_PageListIteratorAlt (vector <MyDB_PageReaderWriter> &forUsIn, bool discardAsReadIn) {
 	forUs = forUsIn;
 	curPage = 0;
-	myIter = forUsIn[curPage].getIteratorAlt ();		
+	discardAsRead = discardAsReadIn;
+	pinned = false;
+	startPage ();
 }
 
-MyDB_PageListIteratorAlt :: ~MyDB_PageListIteratorAlt () {}
+MyDB_PageListIteratorAlt :: ~MyDB_PageListIteratorAlt () {
+	if (pinned)
+		forUs[curPage].unpin ();
+}
 
 #endif
@@ -18,12 +18,20 @@
 #include "MyDB_PageRecIterator.h"
 #include "MyDB_PageRecIteratorAlt.h"
 #include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_PaxPageRecIterator.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
 #include "RecordComparator.h"
 
-#define PAGE_TYPE *((MyDB_PageType *) ((char *) myPage->getBytes ()))
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+// the two words of the page header (see PAGE_HEADER_BYTES in MyDB_PageType.h)... the checksum
+// that shares the first word with the page type is described in MyDB_Checksum.h
+#define PAGE_TYPE *((MyDB_PageType *) ((char *) myPage.getBytes ()))
+#define NUM_BYTES_USED *((size_t *) (((char *) myPage.getBytes ()) + sizeof (size_t)))
 #define NUM_BYTES_LEFT (pageSize - NUM_BYTES_USED)
 
+// the slot directory of a SlottedPage (see MyDB_PageType.h)
+#define NUM_SLOTS slottedPageNumSlots (myPage.getBytes (), pageSize)
+#define SLOT_DIRECTORY_BYTES (sizeof (size_t) + NUM_SLOTS * sizeof (uint32_t))
+
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage) {
 
 	// get the actual page
@@ -34,11 +42,18 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent,
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage) {
 
 	// get the actual page
-	if (pinned) {
+	// if there is no frame to pin the page in, it is not pinned
+	if (pinned)
 		myPage = parent.getBufferMgr ()->getPinnedPage (parent.getTable (), whichPage);
-	} else {
+	if (myPage == nullptr)
 		myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
-	}
+	pageSize = parent.getBufferMgr ()->getPageSize ();
+}
+
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage, bool sequentialScan) {
+
+	// get the actual page
+	myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage, sequentialScan);
 	pageSize = parent.getBufferMgr ()->getPageSize ();
 }
 
@@ -50,44 +65,152 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent) {
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent) {
 
-	if (pinned) {
+	if (pinned)
 		myPage = parent.getPinnedPage ();
-	} else {
+	if (myPage == nullptr)
 		myPage = parent.getPage ();	
-	}
+	pageSize = parent.getPageSize ();
+	clear ();
+}
+
+MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent, size_t reservedSlot) {
+	myPage = parent.getPage (reservedSlot);
 	pageSize = parent.getPageSize ();
 	clear ();
 }
 
 void MyDB_PageReaderWriter :: clear () {
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	PAGE_TYPE = MyDB_PageType :: RegularPage;
-	myPage->wroteBytes ();	
+	clear (MyDB_PageType :: RegularPage);
+}
+
+void MyDB_PageReaderWriter :: clear (MyDB_PageType toMe) {
+	NUM_BYTES_USED = PAGE_HEADER_BYTES;
+	PAGE_TYPE = toMe;
+	if (toMe == MyDB_PageType :: SlottedPage)
+		NUM_SLOTS = 0;
+
+	// the columns of a PaxPage are set up when the first record is appended
+	if (toMe == MyDB_PageType :: PaxPage) {
+		paxPageHeader (myPage.getBytes ()) = {0, 0};
+		NUM_BYTES_USED += sizeof (PaxHeader);
+	}
+	myPage.wroteBytes ();	
 }
 
 MyDB_PageType MyDB_PageReaderWriter :: getType () {
 	return PAGE_TYPE;
 }
 
-MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs) {
-	return make_shared <MyDB_PageListIteratorAlt> (forUs);
+MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, bool discardAsRead) {
+	return make_shared <MyDB_PageListIteratorAlt> (forUs, discardAsRead);
 }
 
 MyDB_RecordIteratorPtr MyDB_PageReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
-	return make_shared <MyDB_PageRecIterator> (myPage, iterateIntoMe);
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageRecIterator> (myPage, iterateIntoMe,
+			paxPageHeader (myPage.getBytes ()).numColumns);
+	return make_shared <MyDB_PageRecIterator> (myPage, iterateIntoMe, pageSize);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt () {
-	return make_shared <MyDB_PageRecIteratorAlt> (myPage);
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		vector <int> allAtts;
+		for (int i = 0; i < (int) paxPageHeader (myPage.getBytes ()).numColumns; i++)
+			allAtts.push_back (i);
+		return make_shared <MyDB_PaxPageRecIteratorAlt> (myPage, allAtts);
+	}
+	return make_shared <MyDB_PageRecIteratorAlt> (myPage, pageSize);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getPinnedIteratorAlt () {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return getIteratorAlt ();
+	return make_shared <MyDB_PageRecIteratorAlt> (myPage, pageSize, true);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt (vector <int> whichAtts) {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageRecIteratorAlt> (myPage, whichAtts);
+	return getIteratorAlt ();
 }
 
 void MyDB_PageReaderWriter :: setType (MyDB_PageType toMe) {
 	PAGE_TYPE = toMe;
-	myPage->wroteBytes ();	
+	myPage.wroteBytes ();	
+}
+
+size_t MyDB_PageReaderWriter :: getNumRecords () {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return paxPageHeader (myPage.getBytes ()).numRecords;
+	if (PAGE_TYPE != MyDB_PageType :: SlottedPage) {
+		cout << "Only a slotted page knows how many records it has!!\n";
+		exit (1);
+	}
+	return NUM_SLOTS;
+}
+
+void *MyDB_PageReaderWriter :: getRecordPointer (size_t k) {
+	char *bytes = (char *) myPage.getBytes ();
+	return bytes + slottedPageSlot (bytes, pageSize, k);
+}
+
+void MyDB_PageReaderWriter :: getRecord (size_t k, MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (getRecordPointer (k));
+}
+
+size_t MyDB_PageReaderWriter :: lowerBound (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+	// while the page is pinned, the records that are probed are just views of it... the last one
+	// is copied at the end, so that lhs does not point at the page once it is let go of
+	bool pinned = pin ();
+	size_t low = 0, high = getNumRecords (), mid = 0;
+	while (low < high) {
+		mid = (low + high) / 2;
+		if (pinned)
+			lhs->viewBinary (getRecordPointer (mid));
+		else
+			lhs->fromBinary (getRecordPointer (mid));
+		if (comparator ())
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (pinned) {
+		if (getNumRecords () > 0)
+			lhs->fromBinary (getRecordPointer (mid));
+		unpin ();
+	}
+	return low;
+}
+
+size_t MyDB_PageReaderWriter :: upperBound (function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+	// as in lowerBound
+	bool pinned = pin ();
+	size_t low = 0, high = getNumRecords (), mid = 0;
+	while (low < high) {
+		mid = (low + high) / 2;
+		if (pinned)
+			rhs->viewBinary (getRecordPointer (mid));
+		else
+			rhs->fromBinary (getRecordPointer (mid));
+		if (comparator ())
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	if (pinned) {
+		if (getNumRecords () > 0)
+			rhs->fromBinary (getRecordPointer (mid));
+		unpin ();
+	}
+	return low;
 }
 
 void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe) {
-	void *recLocation = NUM_BYTES_USED + (char *)  myPage->getBytes ();
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return appendPax (appendMe);
+	void *recLocation = NUM_BYTES_USED + (char *)  myPage.getBytes ();
 	if (append (appendMe))
 		return recLocation;
 	else
@@ -96,73 +219,206 @@ void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe)
 
 bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return appendPax (appendMe) != nullptr;
+
 	size_t recSize = appendMe->getBinarySize ();
-	if (recSize > NUM_BYTES_LEFT)
+
+	// a slotted page also needs room for one more slot
+	if (PAGE_TYPE == MyDB_PageType :: SlottedPage) {
+		if (recSize + sizeof (uint32_t) > NUM_BYTES_LEFT - SLOT_DIRECTORY_BYTES)
+			return false;
+		size_t &numSlots = NUM_SLOTS;
+		slottedPageSlot (myPage.getBytes (), pageSize, numSlots++) = NUM_BYTES_USED;
+	} else if (recSize > NUM_BYTES_LEFT) {
 		return false;
+	}
 
 	// write at the end
-	void *address = myPage->getBytes ();
+	void *address = myPage.getBytes ();
 	appendMe->toBinary (NUM_BYTES_USED + (char *) address);
 	NUM_BYTES_USED += recSize;
-	myPage->wroteBytes ();
+	myPage.wroteBytes ();
+	return true;
+}
+
+void *MyDB_PageReaderWriter :: appendPax (MyDB_RecordPtr appendMe) {
+
+	MyDB_SchemaPtr mySchema = appendMe->getSchema ();
+	if (mySchema == nullptr) {
+		cout << "Only a record with a schema can be appended to a PAX page!!\n";
+		exit (1);
+	}
+	vector <pair <string, MyDB_AttTypePtr>> &atts = mySchema->getAtts ();
+	char *bytes = (char *) myPage.getBytes ();
+	PaxHeader &header = paxPageHeader (bytes);
+	PaxColumn *columns = paxPageColumns (bytes);
+
+	// the first record sets up the columns, with nothing in them
+	if (header.numColumns == 0) {
+		size_t dataStart = ((char *) (columns + atts.size ())) - bytes;
+		if (dataStart > pageSize)
+			return nullptr;
+		header.numColumns = atts.size ();
+		for (size_t c = 0; c < atts.size (); c++)
+			columns[c] = {(uint32_t) dataStart, 0, (uint32_t) atts[c].second->getFixedSize ()};
+		NUM_BYTES_USED += atts.size () * sizeof (PaxColumn);
+	} else if (header.numColumns != atts.size ()) {
+		cout << "Appending a record with " << atts.size () << " attributes to a PAX page with "
+			<< header.numColumns << " columns!!\n";
+		exit (1);
+	}
+
+	// serialize the record, and then find the bytes of each attribute's value in it: the
+	// attributes of a fixed-width record are at their offsets; otherwise, each one has its
+	// length in front of it (which a column with a width does not keep)
+	size_t recSize = appendMe->getBinarySize ();
+	if (paxScratch.size () < recSize)
+		paxScratch.resize (recSize);
+	char *rec = paxScratch.data ();
+	appendMe->toBinary (rec);
+	vector <char *> values (atts.size ());
+	vector <size_t> adding (atts.size ());
+	bool fits = true;
+	char *pos = rec + sizeof (short);
+	for (size_t c = 0; c < atts.size (); c++) {
+		if (appendMe->getFixedSize () > 0) {
+			values[c] = rec + mySchema->getFixedOffsets ()[c];
+			adding[c] = columns[c].width;
+		} else {
+			size_t len = *((short *) pos);
+			values[c] = columns[c].width > 0 ? pos + sizeof (short) : pos;
+			adding[c] = columns[c].width > 0 ? columns[c].width : len;
+			pos += len;
+		}
+		if (columns[c].used + adding[c] > paxColumnCapacity (bytes, pageSize, c))
+			fits = false;
+	}
+
+	// if one of the minipages is full, give it some of the room in the others
+	if (!fits && !layOutPax (adding))
+		return nullptr;
+
+	// and write the values at the ends of their minipages
+	for (size_t c = 0; c < atts.size (); c++) {
+		memcpy (bytes + columns[c].start + columns[c].used, values[c], adding[c]);
+		columns[c].used += adding[c];
+		NUM_BYTES_USED += adding[c];
+	}
+	header.numRecords++;
+	myPage.wroteBytes ();
+	return bytes + columns[0].start + columns[0].used - adding[0];
+}
+
+bool MyDB_PageReaderWriter :: layOutPax (vector <size_t> &adding) {
+
+	char *bytes = (char *) myPage.getBytes ();
+	PaxColumn *columns = paxPageColumns (bytes);
+	size_t numColumns = paxPageHeader (bytes).numColumns;
+	size_t dataStart = ((char *) (columns + numColumns)) - bytes;
+
+	// see how much room the columns need
+	vector <size_t> needs (numColumns);
+	size_t totNeeded = 0;
+	for (size_t c = 0; c < numColumns; c++) {
+		needs[c] = columns[c].used + adding[c];
+		totNeeded += needs[c];
+	}
+	if (dataStart + totNeeded > pageSize)
+		return false;
+
+	// the room that is left over is handed out in proportion to what each column needs, so
+	// that the minipages tend to fill up at the same time
+	size_t spare = pageSize - dataStart - totNeeded;
+	char *temp = (char *) malloc (pageSize);
+	memcpy (temp, bytes, pageSize);
+	size_t start = dataStart;
+	for (size_t c = 0; c < numColumns; c++) {
+		memcpy (bytes + start, temp + columns[c].start, columns[c].used);
+		columns[c].start = start;
+		start += needs[c] + (totNeeded == 0 ? 0 : spare * needs[c] / totNeeded);
+	}
+	free (temp);
+	myPage.wroteBytes ();
 	return true;
 }
 
 void MyDB_PageReaderWriter :: 
 	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		cout << "A PAX page cannot be sorted!!\n";
+		exit (1);
+	}
+
+	// on a slotted page, we just sort the slots... the records stay where they are, so the page
+	// has to stay put until we are done
+	if (PAGE_TYPE == MyDB_PageType :: SlottedPage) {
+		bool pinned = pin ();
+		char *bytes = (char *) myPage.getBytes ();
+		vector <void *> positions = getPositions (bytes, lhs);
+		RecordComparator myComparator (comparator, lhs, rhs);
+		std::stable_sort (positions.begin (), positions.end (), myComparator);
+		for (size_t k = 0; k < positions.size (); k++)
+			slottedPageSlot (bytes, pageSize, k) = ((char *) positions[k]) - bytes;
+		myPage.wroteBytes ();
+
+		// the records that were compared are views of the page (see RecordComparator), so give
+		// them copies before the page is let go of
+		if (positions.size () > 0) {
+			lhs->fromBinary (positions[0]);
+			rhs->fromBinary (positions[0]);
+		}
+		if (pinned)
+			unpin ();
+		return;
+	}
+
 	void *temp = malloc (pageSize);
-	memcpy (temp, myPage->getBytes (), pageSize);
+	memcpy (temp, myPage.getBytes (), pageSize);
 
 	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
-	}
+	vector <void *> positions = getPositions (temp, lhs);
 
 	// and now we sort the vector of positions, using the record contents to build a comparator
 	RecordComparator myComparator (comparator, lhs, rhs);
 	std::stable_sort (positions.begin (), positions.end (), myComparator);
 
 	// and write the guys back
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	myPage->wroteBytes ();	
+	NUM_BYTES_USED = PAGE_HEADER_BYTES;
+	myPage.wroteBytes ();	
 	for (void *pos : positions) {
 		lhs->fromBinary (pos);
 		append (lhs);
 	}
 
+	// rhs is still a view of one of the records that were compared
+	if (positions.size () > 0)
+		rhs->fromBinary (positions[0]);
 	free (temp);
 }
 
 MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: 
 	sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) myPage->getBytes ();
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		cout << "A PAX page cannot be sorted!!\n";
+		exit (1);
 	}
 
+	// the positions below point right into the page, so it has to stay put until we are done
+	bool pinned = pin ();
+
+	// first, read in the positions of all of the records
+	vector <void *> positions = getPositions (myPage.getBytes (), lhs);
+
 	// and now we sort the vector of positions, using the record contents to build a comparator
 	RecordComparator myComparator (comparator, lhs, rhs);
 	std::stable_sort (positions.begin (), positions.end (), myComparator);
 
 	// and now create the page to return
-	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent ());
-	returnVal->clear ();
+	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage.getParent ());
+	returnVal->clear (PAGE_TYPE == MyDB_PageType :: SlottedPage ? MyDB_PageType :: SlottedPage : MyDB_PageType :: RegularPage);
 	
 	// loop through all of the sorted records and write them out
 	for (void *pos : positions) {
@@ -170,15 +426,70 @@ MyDB_PageReaderWriterPtr MyDB_PageReaderWriter ::
 		returnVal->append (lhs);
 	}
 
+	// rhs is still a view of one of the records that were compared
+	if (positions.size () > 0)
+		rhs->fromBinary (positions[0]);
+	if (pinned)
+		unpin ();
 	return returnVal;
 }
 
+vector <void *> MyDB_PageReaderWriter :: getPositions (void *bytes, MyDB_RecordPtr useMe) {
+
+	vector <void *> positions;
+
+	// a slotted page has them all in its slot directory
+	if (PAGE_TYPE == MyDB_PageType :: SlottedPage) {
+		size_t numSlots = slottedPageNumSlots (bytes, pageSize);
+		positions.reserve (numSlots);
+		for (size_t k = 0; k < numSlots; k++)
+			positions.push_back (((char *) bytes) + slottedPageSlot (bytes, pageSize, k));
+		return positions;
+	}
+
+	// records in the fixed-width format are all the same size, so they need not be read
+	size_t bytesConsumed = PAGE_HEADER_BYTES;
+	size_t numBytesUsed = *((size_t *) (((char *) bytes) + sizeof (size_t)));
+	size_t stride = useMe->getFixedSize ();
+	if (stride > 0) {
+		positions.reserve ((numBytesUsed - bytesConsumed) / stride);
+		for (; bytesConsumed < numBytesUsed; bytesConsumed += stride)
+			positions.push_back (bytesConsumed + (char *) bytes);
+		return positions;
+	}
+
+	// this basically iterates through all of the records on the page
+	while (bytesConsumed != numBytesUsed) {
+		void *pos = bytesConsumed + (char *) bytes;
+		positions.push_back (pos);
+		void *nextPos = useMe->fromBinary (pos);
+		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	}
+	return positions;
+}
+
 size_t MyDB_PageReaderWriter :: getPageSize () {
 	return pageSize;
 }
 
 void *MyDB_PageReaderWriter :: getBytes () {
-	return myPage->getBytes ();
+	return myPage.getBytes ();
+}
+
+bool MyDB_PageReaderWriter :: pin () {
+	return myPage.pin ();
+}
+
+void MyDB_PageReaderWriter :: unpin () {
+	myPage.unpin ();
+}
+
+void MyDB_PageReaderWriter :: setDiscardable () {
+	myPage.setDiscardable ();
+}
+
+void MyDB_PageReaderWriter :: setLSN (size_t lsn) {
+	myPage.setLSN (lsn);
 }
 
 #endif
@@ -16,26 +16,39 @@
 #include "MyDB_PageRecIterator.h"
 #include "MyDB_PageType.h"
 
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+#define NUM_BYTES_USED *((size_t *) (((char *) myPage.getBytes ()) + sizeof (size_t)))
 
 void MyDB_PageRecIterator :: getNext () {
-	void *pos = bytesConsumed + (char *) myPage->getBytes ();
+	if (slotted) {
+		myRec->fromBinary (getCurrentPointer ());
+		nextSlot++;
+		return;
+	}
+	void *pos = bytesConsumed + (char *) myPage.getBytes ();
  	void *nextPos = myRec->fromBinary (pos);
 	bytesConsumed += ((char *) nextPos) - ((char *) pos);	
 }
 
 void *MyDB_PageRecIterator :: getCurrentPointer () {
-	return bytesConsumed + (char *) myPage->getBytes ();
+	char *bytes = (char *) myPage.getBytes ();
+	if (slotted)
+		return bytes + slottedPageSlot (bytes, pageSize, nextSlot);
+	return bytesConsumed + bytes;
 }
 
 bool MyDB_PageRecIterator :: hasNext () {
+	if (slotted)
+		return nextSlot < slottedPageNumSlots (myPage.getBytes (), pageSize);
 	return bytesConsumed != NUM_BYTES_USED;
 }
 
-MyDB_PageRecIterator :: MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn) {
-	bytesConsumed = sizeof (size_t) * 2;
+MyDB_PageRecIterator :: MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn, size_t pageSizeIn) {
+	bytesConsumed = PAGE_HEADER_BYTES;
 	myPage = myPageIn;
 	myRec = myRecIn;
+	pageSize = pageSizeIn;
+	slotted = *((MyDB_PageType *) myPage.getBytes ()) == MyDB_PageType :: SlottedPage;
+	nextSlot = 0;
 }
 
 MyDB_PageRecIterator :: ~MyDB_PageRecIterator () {}
@@ -16,16 +16,26 @@
 #include "MyDB_PageRecIteratorAlt.h"
 #include "MyDB_PageType.h"
 
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+#define NUM_BYTES_USED *((size_t *) (((char *) myPage.getBytes ()) + sizeof (size_t)))
 
 void MyDB_PageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
-	void *pos = bytesConsumed + (char *) myPage->getBytes ();
- 	void *nextPos = intoMe->fromBinary (pos);
+	void *pos = bytesConsumed + (char *) myPage.getBytes ();
+ 	void *nextPos = intoMe->fromBinary (pos, pinned);
+	nextRecSize = ((char *) nextPos) - ((char *) pos);	
+}
+
+void MyDB_PageRecIteratorAlt :: getCurrentView (MyDB_RecordPtr intoMe) {
+	if (!pinned) {
+		getCurrent (intoMe);
+		return;
+	}
+	void *pos = bytesConsumed + (char *) myPage.getBytes ();
+ 	void *nextPos = intoMe->viewBinary (pos);
 	nextRecSize = ((char *) nextPos) - ((char *) pos);	
 }
 
 void *MyDB_PageRecIteratorAlt :: getCurrentPointer () {
-	return bytesConsumed + (char *) myPage->getBytes ();
+	return bytesConsumed + (char *) myPage.getBytes ();
 }
 
 bool MyDB_PageRecIteratorAlt :: advance () {
@@ -33,15 +43,30 @@ bool MyDB_PageRecIteratorAlt :: advance () {
 		cout << "You can't call advance without calling getCurrent!!\n";
 		exit (1);
 	}
+
+	// on a slotted page, go to the next slot
+	if (slotted) {
+		nextRecSize = -1;
+		void *bytes = myPage.getBytes ();
+		if (++curSlot >= (long) slottedPageNumSlots (bytes, pageSize))
+			return false;
+		bytesConsumed = slottedPageSlot (bytes, pageSize, curSlot);
+		return true;
+	}
+
 	bytesConsumed += nextRecSize;
 	nextRecSize = -1;
 	return bytesConsumed != NUM_BYTES_USED;
 }
 
-MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn) {
-	bytesConsumed = sizeof (size_t) * 2;
+MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn, bool pinnedIn) {
+	bytesConsumed = PAGE_HEADER_BYTES;
 	myPage = myPageIn;
 	nextRecSize = 0;
+	pageSize = pageSizeIn;
+	slotted = *((MyDB_PageType *) myPage.getBytes ()) == MyDB_PageType :: SlottedPage;
+	curSlot = -1;
+	pinned = pinnedIn;
 }
 
 MyDB_PageRecIteratorAlt :: ~MyDB_PageRecIteratorAlt () {}
@@ -0,0 +1,44 @@
+
+#ifndef PAX_PAGE_REC_ITER_C
+#define PAX_PAGE_REC_ITER_C
+
+#include "MyDB_PaxPageRecIterator.h"
+
+using namespace std;
+
+// all of the attributes of a record with numAtts of them
+static vector <int> allAtts (int numAtts) {
+	vector <int> returnVal;
+	for (int i = 0; i < numAtts; i++)
+		returnVal.push_back (i);
+	return returnVal;
+}
+
+void MyDB_PaxPageRecIterator :: getNext () {
+	hasNext ();
+	myIter.getCurrent (myRec);
+	advanced = false;
+}
+
+bool MyDB_PaxPageRecIterator :: hasNext () {
+	if (!advanced) {
+		haveNext = myIter.advance ();
+		advanced = true;
+	}
+	return haveNext;
+}
+
+void *MyDB_PaxPageRecIterator :: getCurrentPointer () {
+	return nullptr;
+}
+
+MyDB_PaxPageRecIterator :: MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn, int numAtts) :
+	myIter (myPageIn, allAtts (numAtts)) {
+	myRec = myRecIn;
+	advanced = false;
+	haveNext = false;
+}
+
+MyDB_PaxPageRecIterator :: ~MyDB_PaxPageRecIterator () {}
+
+#endif
@@ -0,0 +1,74 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_C
+#define PAX_PAGE_REC_ITER_ALT_C
+
+#include <iostream>
+#include "MyDB_PageType.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
+
+using namespace std;
+
+void MyDB_PaxPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	char *bytes = (char *) myPage.getBytes ();
+	PaxColumn *columns = paxPageColumns (bytes);
+	for (size_t i = 0; i < whichAtts.size (); i++) {
+		int att = whichAtts[i];
+		if (columns[att].width > 0)
+			intoMe->getAtt (att)->setBuffered (bytes + positions[i]);
+		else
+			intoMe->getAtt (att)->fromBinary (bytes + positions[i]);
+	}
+
+	// the record's own copy of its bytes no longer matches its attributes
+	intoMe->recordContentHasChanged ();
+}
+
+void *MyDB_PaxPageRecIteratorAlt :: getCurrentPointer () {
+	return nullptr;
+}
+
+bool MyDB_PaxPageRecIteratorAlt :: advance () {
+	if (curRec + 1 >= numRecords) {
+		curRec = numRecords;
+		return false;
+	}
+
+	// step each of the columns that we are reading past the value of the record that we were on
+	if (curRec >= 0) {
+		char *bytes = (char *) myPage.getBytes ();
+		PaxColumn *columns = paxPageColumns (bytes);
+		for (size_t i = 0; i < whichAtts.size (); i++) {
+			size_t width = columns[whichAtts[i]].width;
+			positions[i] += width > 0 ? width : *((short *) (bytes + positions[i]));
+		}
+	}
+	curRec++;
+	return true;
+}
+
+MyDB_PaxPageRecIteratorAlt :: MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, vector <int> whichAttsIn) {
+	myPage = myPageIn;
+	pinned = myPage.pin ();
+	whichAtts = whichAttsIn;
+	curRec = -1;
+
+	void *bytes = myPage.getBytes ();
+	PaxHeader &header = paxPageHeader (bytes);
+	numRecords = header.numRecords;
+	for (int att : whichAtts) {
+		if (att < 0 || att >= (long) header.numColumns) {
+			if (numRecords == 0)
+				break;
+			cout << "Asked for attribute " << att << " of a PAX page with " << header.numColumns << " columns!!\n";
+			exit (1);
+		}
+		positions.push_back (paxPageColumns (bytes)[att].start);
+	}
+}
+
+MyDB_PaxPageRecIteratorAlt :: ~MyDB_PaxPageRecIteratorAlt () {
+	if (pinned)
+		myPage.unpin ();
+}
+
+#endif
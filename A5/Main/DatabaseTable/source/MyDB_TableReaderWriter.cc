@@ -17,6 +17,7 @@
 #include <limits>
 #include <queue>
 #include "MyDB_PageReaderWriter.h"
+#include "MyDB_PageType.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
@@ -26,14 +27,25 @@
 
 using namespace std;
 
-MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) {
+MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) :
+	MyDB_TableReaderWriter (forMeIn, myBufferIn, false) {}
+
+MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn,
+	bool readOnly) {
 	forMe = forMeIn;
 	myBuffer = myBufferIn;
 
+	// the mapping has to be there before we get to any of the pages
+	if (readOnly)
+		myBuffer->mapReadOnly (forMe);
+
+	// only the heap tables are logged (the B+-Trees write their pages themselves)
+	if (!readOnly && forMe->getFileType () == "heap")
+		log = myBuffer->getLog ();
+
 	if (forMe->lastPage () == -1) {
 		forMe->setLastPage (0);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();
+		clearLastPage ();
 	} else {
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());	
 	}
@@ -55,13 +67,21 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: getPinned (size_t i) {
 	return MyDB_PageReaderWriter (true, *this, i);
 }
 
+MyDB_PageReaderWriter MyDB_TableReaderWriter :: getForScan (size_t i) {
+
+	// if we are going off of the end of the file, let operator [] clear those pages
+	if ((int) i > forMe->lastPage ())
+		(*this)[i];
+
+	return MyDB_PageReaderWriter (*this, i, true);
+}
+
 MyDB_PageReaderWriter MyDB_TableReaderWriter :: operator [] (size_t i) {
 	
 	// see if we are going off of the end of the file... if so, then clear those pages
 	while (i > forMe->lastPage ()) {
 		forMe->setLastPage (forMe->lastPage () + 1);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();	
+		clearLastPage ();
 	}
 
 	// now get the page
@@ -83,13 +103,36 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: last () {
 void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
 	// try to append the record on the current page...
-	if (!lastPage->append (appendMe)) {
+	void *location = lastPage->appendAndReturnLocation (appendMe);
+	if (location == nullptr) {
 
 		// if we cannot, then get a new last page and append
 		forMe->setLastPage (forMe->lastPage () + 1);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
+		clearLastPage ();
+		location = lastPage->appendAndReturnLocation (appendMe);
+	}
+
+	// log the record, along with the page header that counts it
+	if (log != nullptr && location != nullptr) {
+		char *bytes = (char *) lastPage->getBytes ();
+		lastPage->setLSN (log->logWrite (forMe, forMe->lastPage (), bytes, ((char *) location) - bytes,
+			appendMe->getBinarySize (), PAGE_HEADER_BYTES));
+	}
+}
+
+void MyDB_TableReaderWriter :: clearLastPage () {
+	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
+	if (forMe->getFileType () == "pax")
+		lastPage->clear (MyDB_PageType :: PaxPage);
+	else
 		lastPage->clear ();
-		lastPage->append (appendMe);
+
+	// the page is logged before the table's new size, so that the table never includes a page
+	// that the log does not know has been cleared
+	if (log != nullptr) {
+		log->logClear (forMe, forMe->lastPage ());
+		lastPage->setLSN (log->logWrite (forMe, forMe->lastPage (), lastPage->getBytes (), 0, PAGE_HEADER_BYTES));
+		log->logCatalog (forMe->getName () + ".lastPage", to_string (forMe->lastPage ()));
 	}
 }
 
@@ -97,8 +140,7 @@ pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (stri
 
 	// empty out the database file
 	forMe->setLastPage (0);
-	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-	lastPage->clear ();
+	clearLastPage ();
 
 	// try to open the file
 	string line;
@@ -173,6 +215,10 @@ MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (int lowPage,
 	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, lowPage, highPage);
 }
 
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (vector <int> whichAtts) {
+	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, whichAtts);
+}
+
 void MyDB_TableReaderWriter :: writeIntoTextFile (string fName) {
 	
 	// open up the output file
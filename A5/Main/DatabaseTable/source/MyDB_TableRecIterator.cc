@@ -25,7 +25,9 @@ void *MyDB_TableRecIterator :: getCurrentPointer () {
 }
 
 bool MyDB_TableRecIterator :: hasNext () {
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->hasNext ())
+	MyDB_PageType type = myParent[curPage].getType ();
+	if ((type == MyDB_PageType :: RegularPage || type == MyDB_PageType :: SlottedPage ||
+		type == MyDB_PageType :: PaxPage) && myIter->hasNext ())
 		return true;
 
 	if (curPage == myTable->lastPage ())
@@ -13,6 +13,7 @@
 #ifndef TABLE_REC_ITER_ALT_C
 #define TABLE_REC_ITER_ALT_C
 
+#include <algorithm>
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIteratorAlt.h"
 
@@ -20,30 +21,72 @@ void MyDB_TableRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
 	myIter->getCurrent (intoMe);
 }
 
+void MyDB_TableRecIteratorAlt :: getCurrentView (MyDB_RecordPtr intoMe) {
+	myIter->getCurrentView (intoMe);
+}
+
 void *MyDB_TableRecIteratorAlt :: getCurrentPointer () {
 	return myIter->getCurrentPointer ();
 }
 
 bool MyDB_TableRecIteratorAlt :: advance () {
 
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
+	if ((scanPageType == MyDB_PageType :: RegularPage || scanPageType == MyDB_PageType :: SlottedPage ||
+		scanPageType == MyDB_PageType :: PaxPage) && myIter->advance ())
 		return true;
 
 	if (curPage == myTable->lastPage () || curPage == highPage)
 		return false;
 
 	curPage++;
-	myIter = myParent[curPage].getIteratorAlt ();
+	readAhead ();
+	startPage ();
 	return advance ();
 }
 
+void MyDB_TableRecIteratorAlt :: startPage () {
+
+	// let go of the last page first, so that its frame can be reused
+	if (pinned)
+		scanPage->unpin ();
+
+	scanPage = make_shared <MyDB_PageReaderWriter> (myParent, curPage, true);
+	pinned = scanPage->pin ();
+	scanPageType = scanPage->getType ();
+	if (projected)
+		myIter = scanPage->getIteratorAlt (whichAtts);
+	else if (pinned)
+		myIter = scanPage->getPinnedIteratorAlt ();
+	else
+		myIter = scanPage->getIteratorAlt ();
+}
+
+void MyDB_TableRecIteratorAlt :: readAhead () {
+
+	// only ask for more once half of the pages we asked for have been used up, so that
+	// the reads go out in batches... and do not bother at all with little tables
+	int lastWanted = min (myTable->lastPage (), highPage);
+	if (myTable->lastPage () < READ_AHEAD_PAGES || readAheadTo > lastWanted || 
+		readAheadTo - curPage > READ_AHEAD_PAGES / 2)
+		return;
+
+	int num = min (curPage + READ_AHEAD_PAGES + 1, lastWanted + 1) - readAheadTo;
+	myParent.getBufferMgr ()->prefetch (myTable, readAheadTo, num, true);
+	readAheadTo += num;
+}
+
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
 	int lowPage, int highPageIn) :
 	myParent (myParent) {
 	myTable = myTableIn;
 	curPage = lowPage;
 	highPage = highPageIn;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	readAheadTo = curPage + 1;
+	myParent.getBufferMgr ()->startScan (myTable);
+	readAhead ();
+	pinned = false;
+	projected = false;
+	startPage ();
 }
 
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn) :
@@ -51,9 +94,33 @@ MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &my
 	myTable = myTableIn;
 	curPage = 0;
 	highPage = 1999999999;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	readAheadTo = curPage + 1;
+	myParent.getBufferMgr ()->startScan (myTable);
+	readAhead ();
+	pinned = false;
+	projected = false;
+	startPage ();
 }
 
-MyDB_TableRecIteratorAlt :: ~MyDB_TableRecIteratorAlt () {}
+MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	vector <int> whichAttsIn) :
+	myParent (myParent) {
+	myTable = myTableIn;
+	curPage = 0;
+	highPage = 1999999999;
+	readAheadTo = curPage + 1;
+	myParent.getBufferMgr ()->startScan (myTable);
+	readAhead ();
+	pinned = false;
+	projected = true;
+	whichAtts = whichAttsIn;
+	startPage ();
+}
+
+MyDB_TableRecIteratorAlt :: ~MyDB_TableRecIteratorAlt () {
+	if (pinned)
+		scanPage->unpin ();
+	myParent.getBufferMgr ()->finishScan (myTable);
+}
 
 #endif
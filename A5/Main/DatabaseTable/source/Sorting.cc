@@ -13,37 +13,75 @@
 
 using namespace std;
 
+// the fewest frames that a sort will run with: one page of a run, the input page and the output page
+#define MIN_SORT_FRAMES 3
+
+// the slots of the temp file that the output of a merge has reserved, and has not used yet
+struct RunSlots {
+	size_t next;
+	size_t numLeft;
+};
+
+// gets a new page for the output of a merge, in the next reserved slot if there is one left
+MyDB_PageReaderWriter nextRunPage (RunSlots &slots, MyDB_BufferManagerPtr parent) {
+	if (slots.numLeft == 0)
+		return MyDB_PageReaderWriter (*parent);
+	slots.numLeft--;
+	return MyDB_PageReaderWriter (*parent, slots.next++);
+}
+
 void appendRecord (MyDB_PageReaderWriter &curPage, vector <MyDB_PageReaderWriter> &returnVal, 
-	MyDB_RecordPtr appendMe, MyDB_BufferManagerPtr parent) {
+	MyDB_RecordPtr appendMe, MyDB_BufferManagerPtr parent, RunSlots &slots) {
 
 	// try to append to the current page
 	if (!curPage.append (appendMe)) {
 
 		// if we cannot, then add a new one to the output vector
 		returnVal.push_back (curPage);
-		MyDB_PageReaderWriter temp (*parent);
+		MyDB_PageReaderWriter temp = nextRunPage (slots, parent);
 		temp.append (appendMe);
 		curPage = temp;
 	}
 }
 
+// gets a pinned, slotted page to gather the records of a one-page run on
+MyDB_PageReaderWriter newRunPage (MyDB_BufferManagerPtr parent) {
+	MyDB_PageReaderWriter runPage (true, *parent);
+	runPage.clear (MyDB_PageType :: SlottedPage);
+	return runPage;
+}
+
+// sorts a page from newRunPage in place and unpins it, so that it can be used as a run
+vector <MyDB_PageReaderWriter> finishRunPage (MyDB_PageReaderWriter &runPage, function <bool ()> comparator,
+	MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+	runPage.sortInPlace (comparator, lhs, rhs);
+	runPage.unpin ();
+	return vector <MyDB_PageReaderWriter> {runPage};
+}
+
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter, 
-	MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+	MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs,
+	size_t maxPages) {
 	
+	// lay the output out in one piece of the temp file, if we know how big it can get
+	RunSlots slots {0, maxPages};
+	if (maxPages > 0)
+		slots.next = parent->reserveTempPages (maxPages);
+
 	vector <MyDB_PageReaderWriter> returnVal;
-	MyDB_PageReaderWriter curPage (*parent);
+	MyDB_PageReaderWriter curPage = nextRunPage (slots, parent);
 	bool lhsLoaded = false, rhsLoaded = false;
 
 	// if one of the runs is empty, get outta here
 	if (!leftIter->advance ()) {
 		while (rightIter->advance ()) {
 			rightIter->getCurrent (rhs);
-			appendRecord (curPage, returnVal, rhs, parent);
+			appendRecord (curPage, returnVal, rhs, parent, slots);
 		}
 	} else if (!rightIter->advance ()) {
 		do {
 			leftIter->getCurrent (lhs);
-			appendRecord (curPage, returnVal, lhs, parent);
+			appendRecord (curPage, returnVal, lhs, parent, slots);
 		} while (leftIter->advance ());
 	} else {
 		while (true) {
@@ -63,28 +101,28 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 	
 			// see if the lhs is less
 			if (comparator ()) {
-				appendRecord (curPage, returnVal, lhs, parent);
+				appendRecord (curPage, returnVal, lhs, parent, slots);
 				lhsLoaded = false;
 
 				// deal with the case where we have to append all of the right records to the output
 				if (!leftIter->advance ()) {
-					appendRecord (curPage, returnVal, rhs, parent);
+					appendRecord (curPage, returnVal, rhs, parent, slots);
 					while (rightIter->advance ()) {
 						rightIter->getCurrent (rhs);
-						appendRecord (curPage, returnVal, rhs, parent);
+						appendRecord (curPage, returnVal, rhs, parent, slots);
 					}
 					break;
 				}
 			} else {
-				appendRecord (curPage, returnVal, rhs, parent);
+				appendRecord (curPage, returnVal, rhs, parent, slots);
 				rhsLoaded = false;
 
 				// deal with the ase where we have to append all of the right records to the output
 				if (!rightIter->advance ()) {
-					appendRecord (curPage, returnVal, lhs, parent);
+					appendRecord (curPage, returnVal, lhs, parent, slots);
 					while (leftIter->advance ()) {
 						leftIter->getCurrent (lhs);
-						appendRecord (curPage, returnVal, lhs, parent);
+						appendRecord (curPage, returnVal, lhs, parent, slots);
 					}
 					break;
 				}
@@ -92,8 +130,10 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 		}
 	}
 	
-	// remember the current page
+	// remember the current page, and give back the slots that we did not need
 	returnVal.push_back (curPage);
+	if (slots.numLeft > 0)
+		parent->releaseTempPages (slots.next, slots.numLeft);
 	
 	// outta here!
 	return returnVal;
@@ -112,7 +152,17 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 	if (lhsPred == "bool[true]")
 		skipPred = true;
 
-	func f = lhs->compileComputation (lhsPred);
+	// the predicate is run over a record of its own, which only reads the attributes that the
+	// predicate uses; a record is read in full only once it passes
+	MyDB_RecordPtr predRec = sortMe.getEmptyRecord ();
+	func f = predRec->compileComputation (lhsPred);
+	predRec->setProjection (predRec->getAttsUsed ());
+
+	// size the runs from the frames that we actually get... if the buffer is too small to
+	// grant even MIN_SORT_FRAMES, just go ahead with the run size that we were given
+	MyDB_FrameReservationPtr frames = sortMe.getBufferMgr ()->reserveFrames (MIN_SORT_FRAMES, runSize + 2);
+	if (frames != nullptr)
+		runSize = frames->getNumFrames () - 2;
 
 	// this is the list of all of the pages in the file
 	vector <vector<MyDB_PageReaderWriter>> allPages;
@@ -123,46 +173,56 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 	// this is the list of all of the iterators, with one for each run
 	vector <MyDB_RecordIteratorAltPtr> runIters;
 	
+	// the records that pass the predicate are gathered on a slotted page, so that once it is
+	// full it can be sorted just by putting its slots in order, and then used as a run as is
+	MyDB_PageReaderWriter tempPage = newRunPage (sortMe.getBufferMgr ());
+
 	// process the file 
-	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
 	for (int i = 0; i < sortMe.getNumPages (); i++) {
 		
-		if (sortMe[i].getType () == MyDB_PageType :: RegularPage) {
-
-			if (skipPred) {
+		// the input is read exactly once, so let the buffer manager know that this is a scan
+		MyDB_PageReaderWriter inputPage = sortMe.getForScan (i);
+		MyDB_PageType inputType = inputPage.getType ();
+		if (inputType == MyDB_PageType :: RegularPage || inputType == MyDB_PageType :: SlottedPage ||
+			inputType == MyDB_PageType :: PaxPage) {
+
+			// a PAX page cannot be sorted as it is, so its records are gathered like the ones
+			// that pass a predicate
+			if (skipPred && inputType != MyDB_PageType :: PaxPage) {
 				vector <MyDB_PageReaderWriter> run;
-				run.push_back (*(sortMe[i].sort (comparator, lhs, rhs)));	
+				run.push_back (*(inputPage.sort (comparator, lhs, rhs)));	
 				pagesToSort.push_back (run);
 			} else {
-				MyDB_RecordIteratorAltPtr temp = sortMe[i].getIteratorAlt ();
+				// while the input page is pinned, the predicate reads its attributes right off of it
+				bool pinned = inputPage.pin ();
+				MyDB_RecordIteratorAltPtr temp = pinned ? inputPage.getPinnedIteratorAlt () : inputPage.getIteratorAlt ();
 				while (temp->advance ()) {
-					temp->getCurrent (lhs);
+					temp->getCurrent (predRec);
 
 					if (!f ()->toBool ())
 						continue;
 
+					temp->getCurrent (lhs);
+
 					if (!tempPage.append (lhs)) {
 	
 						// remember the old page
-						vector <MyDB_PageReaderWriter> run;
-						run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
-						pagesToSort.push_back (run);
+						pagesToSort.push_back (finishRunPage (tempPage, comparator, lhs, rhs));
 	
 						// get the new page
-						tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
+						tempPage = newRunPage (sortMe.getBufferMgr ());
 						temp->getCurrent (lhs);
 						tempPage.append (lhs);
 					}
 				}
+				if (pinned)
+					inputPage.unpin ();
 			}
 		}
 
 		// if we are all done, remember the last page
-		if (i == sortMe.getNumPages () - 1) {
-			vector <MyDB_PageReaderWriter> run;
-			run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
-			pagesToSort.push_back (run);
-		}
+		if (i == sortMe.getNumPages () - 1)
+			pagesToSort.push_back (finishRunPage (tempPage, comparator, lhs, rhs));
 
 		// if we are not done reading this run, go on to the next one
 		if (pagesToSort.size () != runSize && i != sortMe.getNumPages () - 1)
@@ -191,8 +251,9 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 				pagesToSort.pop_back ();
 		
 				// merge them
-				newPagesToSort.push_back (mergeIntoList (sortMe.getBufferMgr (), getIteratorAlt (runOne), 
-					getIteratorAlt (runTwo), comparator, lhs, rhs));
+				// (each run is read just once, by the merge)
+				newPagesToSort.push_back (mergeIntoList (sortMe.getBufferMgr (), getIteratorAlt (runOne, true), 
+					getIteratorAlt (runTwo, true), comparator, lhs, rhs, runOne.size () + runTwo.size ()));
 			}
 	
 			pagesToSort = newPagesToSort;
@@ -200,14 +261,15 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 
 		
 		// now we have a single list, so create an iterator for it
-		runIters.push_back (getIteratorAlt (pagesToSort[0]));
+		runIters.push_back (getIteratorAlt (pagesToSort[0], true));
 
 		// and start over on the next run
 		pagesToSort.clear ();
 	}
 	
-	// and now, we are ready to merge everything
+	// and now, we are ready to merge everything... the merge holds on to the frames
 	MyDB_RunQueueIteratorAltPtr temp = make_shared <MyDB_RunQueueIteratorAlt> (comparator, lhs, rhs);
+	temp->holdFrames (frames);
 
 	// load up the set
 	for (MyDB_RecordIteratorAltPtr m : runIters) {
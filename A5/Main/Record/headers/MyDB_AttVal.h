@@ -35,6 +35,9 @@ public:
 	virtual void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) = 0;
 	virtual ~MyDB_AttVal ();
 
+	// writes just the bytes of the value (with no length) to toHere, for the fixed-width row format
+	virtual void serializeFixed (char *toHere) = 0;
+
 	// this gets a pointer to our data... useful because we can avoid deserializing the record
 	inline void *getDataPointer () {
 		return myData;
@@ -96,6 +99,7 @@ public:
 	size_t hash () override;
 	MyDB_AttValPtr getCopy () override;
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void serializeFixed (char *toHere) override;
 	void set (int val);
 	MyDB_IntAttVal ();
 	~MyDB_IntAttVal ();
@@ -122,6 +126,7 @@ public:
 	void set (MyDB_AttValPtr toMe) override;
 	void fromString (string &fromMe) override;
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void serializeFixed (char *toHere) override;
 	void set (double val);
 	MyDB_DoubleAttVal ();
 	~MyDB_DoubleAttVal ();
@@ -147,6 +152,7 @@ public:
 	size_t hash () override;
 	void set (MyDB_AttValPtr toMe) override;
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void serializeFixed (char *toHere) override;
 	void fromInt (int fromMe) override;
 	void set (string val);
 	MyDB_StringAttVal ();
@@ -174,6 +180,7 @@ public:
 	size_t hash () override;
 	void fromInt (int fromMe) override;
 	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+	void serializeFixed (char *toHere) override;
 	void set (bool val);
 	MyDB_BoolAttVal ();
 	~MyDB_BoolAttVal ();
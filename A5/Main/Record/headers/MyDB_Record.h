@@ -6,6 +6,7 @@
 #include "MyDB_AttVal.h"
 #include "MyDB_Schema.h"
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,31 @@ public:
 	// 	
 	void *fromBinary (void *startPos);
 
+	// like the above, except that if the record has a projection (see below) and pinned is true,
+	// the attributes that are read are pointed right at the bytes at startPos, and nothing is
+	// copied... so pinned should only be true if those bytes are on a page that is going to stay
+	// pinned for as long as the record is used
+	void *fromBinary (void *startPos, bool pinned);
+
+	// makes the record a read-only view of the record at startPos: its attributes (the ones in
+	// its projection, if it has one) are pointed right at those bytes, and nothing is copied, so
+	// the bytes have to stay put (on a pinned page, say) for as long as the record is used.  The
+	// record can still be written, as it is then serialized from its attributes again
+	void *viewBinary (void *startPos);
+
+	// gives the record a projection: from now on, fromBinary only reads the attributes whose
+	// indexes are in whichAtts, and skips over the bytes of the others, which are left as they
+	// were.  A record with a projection is for reading... it should not be written anywhere
+	void setProjection (vector <int> whichAtts);
+
+	// gets rid of the projection, so that fromBinary reads every attribute again
+	void clearProjection ();
+
+	// the indexes of the attributes that the computations compiled over this record so far (by
+	// compileComputation or buildRecordComparator) use, in order... this is the projection that
+	// a record needs if all that is done with it is to run those computations
+	vector <int> getAttsUsed ();
+
 	// parse the contents of this record from the given string
 	void fromString (string fromMe);
 
@@ -115,6 +141,10 @@ public:
 	// access a particular attribute
 	MyDB_AttValPtr &getAtt (int whichAtt);
 
+	// if the record's schema uses the fixed-width row format (see MyDB_Schema :: isFixedWidth),
+	// the number of bytes in every record; otherwise zero
+	size_t getFixedSize ();
+
 private:
 
 	// for fast reading from a page; the contents of the record are simply copied into this buffer
@@ -153,6 +183,22 @@ private:
 	// true when the set of attributes don't match the attribute buffer
 	bool bufferOld;
 
+	// the schema's fixed-width layout, if it has one (fixedSize is zero if it does not)
+	size_t fixedSize;
+	vector <size_t> fixedOffsets;
+
+	// the projection: whether each attribute is read, and the last one that is (the bytes after
+	// it are not even looked at)... projected is false if every attribute is read
+	bool projected;
+	vector <bool> needed;
+	int lastNeeded;
+
+	// reads a record when there is a projection
+	void *fromBinaryProjected (char *fromHere, bool pinned);
+
+	// the attributes used by the computations that have been compiled over this record
+	set <int> attsUsed;
+
 	// this is a subtype
 	friend class MyDB_INRecord;
 
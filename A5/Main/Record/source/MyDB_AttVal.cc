@@ -96,6 +96,10 @@ void MyDB_IntAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &
 	totSize += sizeof (int);
 }
 
+void MyDB_IntAttVal :: serializeFixed (char *toHere) {
+	*((int *) toHere) = toInt ();
+}
+
 void MyDB_IntAttVal :: set (int val) {
 	value = val;
 	setNotBuffered ();
@@ -157,6 +161,10 @@ void MyDB_DoubleAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_
 	totSize += sizeof (double);
 }
 
+void MyDB_DoubleAttVal :: serializeFixed (char *toHere) {
+	*((double *) toHere) = toDouble ();
+}
+
 void MyDB_DoubleAttVal :: set (double val) {
 	value = val;
 	setNotBuffered ();
@@ -217,6 +225,11 @@ void MyDB_StringAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_
 	totSize += strlen (value.c_str ()) + 1;
 }
 
+void MyDB_StringAttVal :: serializeFixed (char *) {
+	cout << "Oops!  A string has no fixed width";
+	exit (1);
+}
+
 void MyDB_StringAttVal :: set (string val) {
         value = val;
 	setNotBuffered ();
@@ -292,6 +305,10 @@ void MyDB_BoolAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t
 	totSize += sizeof (char);
 }
 
+void MyDB_BoolAttVal :: serializeFixed (char *toHere) {
+	*toHere = toBool () ? 1 : 0;
+}
+
 void MyDB_BoolAttVal :: set (bool val) {
 	value = val;
 	setNotBuffered ();
@@ -4,6 +4,7 @@
 
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
+#include <algorithm>
 #include <iostream>
 #include <string.h>
 
@@ -393,6 +394,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName) {
 
 	// just return a particular attribute
 	auto whichAtt = mySchema->getAttByName (attName);
+	if (whichAtt.first >= 0)
+		attsUsed.insert (whichAtt.first);
 	return make_pair ([this, whichAtt] {return values[whichAtt.first];}, whichAtt.second);		
 }
 
@@ -755,6 +758,17 @@ void MyDB_Record :: recordContentHasChanged () {
 }
 
 void MyDB_Record :: writeAttsToBuffer () {
+
+	// in the fixed-width format, each attribute just goes at its offset (the buffer was made
+	// big enough for the record when the record was created)
+	if (fixedSize > 0) {
+		for (size_t i = 0; i < values.size (); i++)
+			values[i]->serializeFixed (buffer + fixedOffsets[i]);
+		recSize = fixedSize;
+		bufferOld = false;
+		return;
+	}
+
 	recSize = sizeof (short);
 	for (MyDB_AttValPtr temp : values) {
 		temp->serialize (buffer, allocatedSize, recSize);
@@ -774,6 +788,24 @@ void *MyDB_Record :: toBinary (void *toHere) {
 }
 
 void *MyDB_Record :: fromBinary (void *fromHere) {
+	return fromBinary (fromHere, false);
+}
+
+void *MyDB_Record :: fromBinary (void *fromHere, bool pinned) {
+
+	if (projected)
+		return fromBinaryProjected ((char *) fromHere, pinned);
+
+	// in the fixed-width format, the size of the record and where each attribute is are known
+	// up front, so there is nothing to decode
+	if (fixedSize > 0) {
+		memcpy (buffer, fromHere, fixedSize);
+		recSize = fixedSize;
+		for (size_t i = 0; i < values.size (); i++)
+			values[i]->setBuffered (buffer + fixedOffsets[i]);
+		bufferOld = false;
+		return ((char *) fromHere) + fixedSize;
+	}
 
 	recSize = *((short *) fromHere);
 
@@ -800,6 +832,87 @@ void *MyDB_Record :: fromBinary (void *fromHere) {
 
 }
 
+void *MyDB_Record :: viewBinary (void *fromHere) {
+
+	if (projected)
+		return fromBinaryProjected ((char *) fromHere, true);
+
+	char *recLoc = (char *) fromHere;
+	if (fixedSize > 0) {
+		for (size_t i = 0; i < values.size (); i++)
+			values[i]->setBuffered (recLoc + fixedOffsets[i]);
+		recSize = fixedSize;
+	} else {
+		recSize = *((short *) recLoc);
+		recLoc += sizeof (short);
+		for (MyDB_AttValPtr &temp : values)
+			recLoc = temp->fromBinary (recLoc);
+	}
+
+	// the buffer does not hold the record
+	bufferOld = true;
+	return ((char *) fromHere) + recSize;
+}
+
+void *MyDB_Record :: fromBinaryProjected (char *fromHere, bool pinned) {
+
+	size_t size = fixedSize > 0 ? fixedSize : *((short *) fromHere);
+
+	// an attribute that is copied goes where it would have been if the whole record had been
+	if (!pinned && size > allocatedSize) {
+		delete [] buffer;
+		buffer = new char[size * 2];
+		allocatedSize = size * 2;
+	}
+	char *base = pinned ? fromHere : buffer;
+
+	if (fixedSize > 0) {
+		for (int i = 0; i <= lastNeeded; i++) {
+			if (!needed[i])
+				continue;
+			if (!pinned) {
+				size_t end = i + 1 < (int) fixedOffsets.size () ? fixedOffsets[i + 1] : fixedSize;
+				memcpy (buffer + fixedOffsets[i], fromHere + fixedOffsets[i], end - fixedOffsets[i]);
+			}
+			values[i]->setBuffered (base + fixedOffsets[i]);
+		}
+	} else {
+		char *recLoc = fromHere + sizeof (short);
+		for (int i = 0; i <= lastNeeded; i++) {
+			short len = *((short *) recLoc);
+			if (needed[i]) {
+				if (!pinned)
+					memcpy (buffer + (recLoc - fromHere), recLoc, len);
+				values[i]->fromBinary (base + (recLoc - fromHere));
+			}
+			recLoc += len;
+		}
+	}
+
+	// the buffer does not hold the record
+	recSize = size;
+	bufferOld = true;
+	return fromHere + size;
+}
+
+void MyDB_Record :: setProjection (vector <int> whichAtts) {
+	projected = true;
+	needed = vector <bool> (values.size (), false);
+	lastNeeded = -1;
+	for (int i : whichAtts) {
+		needed[i] = true;
+		lastNeeded = max (lastNeeded, i);
+	}
+}
+
+void MyDB_Record :: clearProjection () {
+	projected = false;
+}
+
+vector <int> MyDB_Record :: getAttsUsed () {
+	return vector <int> (attsUsed.begin (), attsUsed.end ());
+}
+
 void MyDB_Record :: fromString (string res) {	
 	int i = 0;
         for (int pos = 0; pos < (int) res.size (); pos = (int) res.find ("|", pos + 1) + 1) {
@@ -848,10 +961,24 @@ MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
 	allocatedSize = 256;
 	recSize = 0;
 	bufferOld = true;
+	fixedSize = 0;
+	projected = false;
+	lastNeeded = -1;
 
 	if (mySchemaIn == nullptr)
 		return;
 
+	// remember the fixed-width layout, and make sure that a whole record fits in the buffer
+	if (mySchema->isFixedWidth ()) {
+		fixedSize = mySchema->getFixedSize ();
+		fixedOffsets = mySchema->getFixedOffsets ();
+		if (fixedSize > allocatedSize) {
+			delete [] buffer;
+			buffer = new char[fixedSize];
+			allocatedSize = fixedSize;
+		}
+	}
+
 	for (auto &val : mySchema->getAtts ()) {
 		values.push_back (val.second->createAtt ());	
 	}
@@ -865,6 +992,10 @@ MyDB_AttValPtr &MyDB_Record :: getAtt (int whichAtt) {
 	return values[whichAtt];
 }
 
+size_t MyDB_Record :: getFixedSize () {
+	return fixedSize;
+}
+
 void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
         vector <MyDB_AttValPtr> newValues;
         for (auto &v : left->values) {
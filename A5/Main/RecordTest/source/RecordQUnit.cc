@@ -14,6 +14,7 @@
 #include "QUnit.h"
 #include <cstring>
 #include <iostream>
+#include <sstream>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -463,6 +464,242 @@ int main(int argc, char *argv[]) {
 		QUNIT_IS_FALSE(result);
 	}
 	FALLTHROUGH_INTENDED;
+	case 10:
+	{
+		// the fixed-width row format for a schema with no strings
+		cout << "TEST 10..." << flush;
+		bool result = true;
+		{
+			cout << "create schema..." << flush;
+			MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
+			mySchema->appendAtt(make_pair("key", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("val", make_shared <MyDB_DoubleAttType>()));
+			mySchema->appendAtt(make_pair("flag", make_shared <MyDB_BoolAttType>()));
+			mySchema->appendAtt(make_pair("other", make_shared <MyDB_IntAttType>()));
+			if (!mySchema->isFixedWidth() || mySchema->getFixedSize() != 17) result = false;
+
+			cout << "write table..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_TablePtr myTable = make_shared <MyDB_Table>("numbers", "numbers.bin", mySchema);
+			{
+				MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+				MyDB_TableReaderWriter numbersTable(myTable, myMgr);
+				MyDB_RecordPtr temp = numbersTable.getEmptyRecord();
+				for (int i = 0; i < 5000; i++) {
+					string text = to_string(i) + "|" + to_string(i / 4.0) + "|" + (i % 3 == 0 ? "true" : "false") + "|" + to_string(-i) + "|";
+					temp->fromString(text);
+					if (temp->getBinarySize() != 17) result = false;
+					numbersTable.append(temp);
+				}
+			}
+			myTable->putInCatalog(myCatalog);
+
+			cout << "read table..." << flush;
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			if (!allTables["numbers"]->getSchema()->isFixedWidth()) result = false;
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter numbersTable(allTables["numbers"], myMgr);
+			MyDB_RecordPtr temp = numbersTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = numbersTable.getIteratorAlt();
+			int counter = 0;
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				if (temp->getAtt(0)->toInt() != counter || temp->getAtt(1)->toDouble() != counter / 4.0 ||
+					temp->getAtt(2)->toBool() != (counter % 3 == 0) || temp->getAtt(3)->toInt() != -counter)
+					result = false;
+				counter++;
+			}
+			if (counter != 5000) result = false;
+
+			// 59 records fit on a page, with no lengths in them
+			if (numbersTable.getNumPages() != 5000 / 59 + 1) result = false;
+
+			// sort a page, which does not have to read the records to find them
+			MyDB_RecordPtr temp2 = numbersTable.getEmptyRecord();
+			function <bool ()> myComp = buildRecordComparator(temp, temp2, "[other]");
+			MyDB_PageReaderWriterPtr sorted = numbersTable[3].sort(myComp, temp, temp2);
+			myIter = sorted->getIteratorAlt();
+			counter = 0;
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				if (temp->getAtt(0)->toInt() != 4 * 59 - 1 - counter) result = false;
+				counter++;
+			}
+			if (counter != 59) result = false;
+
+			// a table from a catalog that does not say which format it is in is in the old format
+			cout << "old catalog..." << flush;
+			myCatalog->putString("numbers.rowFormat", "");
+			MyDB_SchemaPtr oldSchema = make_shared <MyDB_Schema>();
+			oldSchema->fromCatalog("numbers", myCatalog);
+			if (oldSchema->isFixedWidth() || oldSchema->getAtts().size() != 4) result = false;
+		}
+		unlink("numbers.bin");
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		// a table stored in PAX pages, read in full and by a projection
+		cout << "TEST 11..." << flush;
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_SchemaPtr mySchema = allTables["supplier"]->getSchema();
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "load tables..." << flush;
+			MyDB_TableReaderWriter heapTable(make_shared <MyDB_Table>("supplier", "supplierHeap.bin", mySchema), myMgr);
+			heapTable.loadFromTextFile("supplier.tbl");
+			MyDB_TablePtr paxTable = make_shared <MyDB_Table>("supplierPax", "supplierPax.bin", mySchema, "pax", "");
+			MyDB_TableReaderWriter supplierPax(paxTable, myMgr);
+			supplierPax.loadFromTextFile("supplier.tbl");
+
+			// every page is a PAX page, and they hold all of the records
+			size_t numRecords = 0;
+			for (int i = 0; i < supplierPax.getNumPages(); i++) {
+				if (supplierPax[i].getType() != MyDB_PageType::PaxPage) result = false;
+				numRecords += supplierPax[i].getNumRecords();
+			}
+			if (numRecords != 10000) result = false;
+
+			cout << "full scan..." << flush;
+			MyDB_RecordPtr heapRec = heapTable.getEmptyRecord();
+			MyDB_RecordPtr paxRec = supplierPax.getEmptyRecord();
+			MyDB_RecordIteratorPtr heapIter = heapTable.getIterator(heapRec);
+			MyDB_RecordIteratorPtr paxIter = supplierPax.getIterator(paxRec);
+			int counter = 0;
+			while (paxIter->hasNext()) {
+				paxIter->getNext();
+				if (!heapIter->hasNext()) result = false;
+				heapIter->getNext();
+				stringstream heapOut, paxOut;
+				heapOut << heapRec;
+				paxOut << paxRec;
+				if (heapOut.str() != paxOut.str()) result = false;
+				counter++;
+			}
+			if (counter != 10000 || heapIter->hasNext()) result = false;
+
+			// only the key, the balance and the comment are read
+			cout << "projected scan..." << flush;
+			MyDB_RecordIteratorAltPtr heapIterAlt = heapTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr paxIterAlt = supplierPax.getIteratorAlt(vector <int> {0, 5, 6});
+			paxRec = supplierPax.getEmptyRecord();
+			counter = 0;
+			while (paxIterAlt->advance()) {
+				paxIterAlt->getCurrent(paxRec);
+				heapIterAlt->advance();
+				heapIterAlt->getCurrent(heapRec);
+				if (paxRec->getAtt(0)->toInt() != heapRec->getAtt(0)->toInt() ||
+					paxRec->getAtt(5)->toDouble() != heapRec->getAtt(5)->toDouble() ||
+					paxRec->getAtt(6)->toString() != heapRec->getAtt(6)->toString() ||
+					paxRec->getAtt(1)->toString() != "")
+					result = false;
+				counter++;
+			}
+			if (counter != 10000) result = false;
+
+			// a record that was read from a PAX page can be written to another table
+			cout << "copy..." << flush;
+			MyDB_TableReaderWriter copyTable(make_shared <MyDB_Table>("supplierCopy", "supplierCopy.bin", mySchema), myMgr);
+			paxIterAlt = supplierPax.getIteratorAlt();
+			while (paxIterAlt->advance()) {
+				paxIterAlt->getCurrent(paxRec);
+				copyTable.append(paxRec);
+			}
+			heapIter = heapTable.getIterator(heapRec);
+			MyDB_RecordIteratorPtr copyIter = copyTable.getIterator(paxRec);
+			counter = 0;
+			while (copyIter->hasNext()) {
+				copyIter->getNext();
+				if (!heapIter->hasNext()) result = false;
+				heapIter->getNext();
+				stringstream heapOut, copyOut;
+				heapOut << heapRec;
+				copyOut << paxRec;
+				if (heapOut.str() != copyOut.str()) result = false;
+				counter++;
+			}
+			if (counter != 10000) result = false;
+		}
+		unlink("supplierHeap.bin");
+		unlink("supplierPax.bin");
+		unlink("supplierCopy.bin");
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		// records with a projection only read some of their attributes
+		cout << "TEST 12..." << flush;
+		bool result = true;
+		{
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(make_shared <MyDB_Table>("supplier", "supplierProj.bin",
+				allTables["supplier"]->getSchema()), myMgr);
+			supplierTable.loadFromTextFile("supplier.tbl");
+
+			// the attributes that a computation uses
+			cout << "compile..." << flush;
+			MyDB_RecordPtr projRec = supplierTable.getEmptyRecord();
+			func pred = projRec->compileComputation("&& (> ([acctbal], double[5000.0]), == ([nationkey], int[7]))");
+			if (projRec->getAttsUsed() != vector <int> {3, 5}) result = false;
+			projRec->setProjection(projRec->getAttsUsed());
+
+			// a scan with the projection finds the same records as one without it; the table
+			// iterator keeps its pages pinned, so the attributes point right at the pages
+			cout << "scan..." << flush;
+			MyDB_RecordPtr fullRec = supplierTable.getEmptyRecord();
+			func fullPred = fullRec->compileComputation("&& (> ([acctbal], double[5000.0]), == ([nationkey], int[7]))");
+			MyDB_RecordIteratorAltPtr projIter = supplierTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr fullIter = supplierTable.getIteratorAlt();
+			int counter = 0, numPassed = 0;
+			while (projIter->advance()) {
+				projIter->getCurrent(projRec);
+				fullIter->advance();
+				fullIter->getCurrent(fullRec);
+				if (pred()->toBool() != fullPred()->toBool()) result = false;
+				if (pred()->toBool()) numPassed++;
+				if (projRec->getAtt(5)->toDouble() != fullRec->getAtt(5)->toDouble()) result = false;
+
+				// the attributes that are not read are left alone
+				if (projRec->getAtt(0)->toInt() != 0 || projRec->getAtt(1)->toString() != "") result = false;
+				counter++;
+			}
+			if (counter != 10000 || numPassed == 0) result = false;
+
+			// reading a record that is not on a pinned page copies what it reads
+			cout << "copy..." << flush;
+			char *bytes = new char[fullRec->getBinarySize()];
+			fullRec->toBinary(bytes);
+			projRec->setProjection(vector <int> {4});
+			if (projRec->fromBinary(bytes) != bytes + fullRec->getBinarySize()) result = false;
+			string phone = fullRec->getAtt(4)->toString();
+			memset(bytes, 0, fullRec->getBinarySize());
+			if (projRec->getAtt(4)->toString() != phone) result = false;
+			delete [] bytes;
+
+			// and with no projection, the whole record is read again
+			projRec->clearProjection();
+			MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(projRec);
+			myIter->hasNext();
+			myIter->getNext();
+			if (projRec->getAtt(0)->toInt() != 1 || projRec->getAtt(1)->toString() != "Supplier#000000001") result = false;
+		}
+		unlink("supplierProj.bin");
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
 	default:
 		break;
 	}
@@ -3,12 +3,14 @@
 #include "Parser.h"
 #include "ParserTypes.h"
 #include "MyDB_BufferManager.h"
+#include "MyDB_LogManager.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
 #include <string>      
 #include <iostream>   
 #include <sstream>
 #include <algorithm>
+#include <cstdlib>
 #include <iterator>
 
 using namespace std;
@@ -28,8 +30,33 @@ int main (int numArgs, char **args) {
 	// open up the catalog file
 	MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> (args [1]);
 
-	// start up the buffer manager
-	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 4028, "tempFile");
+	// start up the buffer manager, sized to fit the memory budget (MYDB_BUFFER_MEMORY, or a
+	// share of the machine's memory), but never smaller than 64 pages; it has room to grow to
+	// twice that with "resize buffer to <pages>".  CLOCK keeps big scans from paying for an
+	// LRU update on every page touch
+	size_t pageSize = 131072;
+	size_t numPages = max (MyDB_BufferManager :: getMemoryBudget () / pageSize, (size_t) 64);
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (pageSize, numPages, "tempFile", 
+		MyDB_ReplacementType :: ClockReplacement, false, numPages * 2);
+
+	// the B+-Trees get a pool of their own, so that a big sort or scan cannot push out the
+	// pages that lookups depend on, and sort scratch (temp pages) may use at most half of the buffer
+	myMgr->createPool ("index", numPages / 8, numPages / 2);
+	myMgr->createPool ("sort", 0, numPages / 2);
+	myMgr->setTempPool ("sort");
+
+	// every page gets a checksum, so that a page torn by a crash is caught when it is read
+	myMgr->setPageChecksums (true);
+
+	// loads and new tables go through a write-ahead log (next to the catalog), and are made
+	// durable when they finish; first, redo whatever the log has that did not make it into
+	// the tables and the catalog before the last run ended
+	MyDB_LogManagerPtr myLog = make_shared <MyDB_LogManager> (string (args [1]) + ".log", pageSize);
+	size_t numRedone = myLog->recover (myCatalog, myMgr->usesPageChecksums ());
+	if (numRedone > 0)
+		cout << "Recovered " << numRedone << " log records.\n";
+	myMgr->setLog (myLog);
+	myCatalog->setLog (myLog);
 
 	// and create tables for everything in the database
 	static map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
@@ -42,9 +69,10 @@ int main (int numArgs, char **args) {
 
 	// load 'em up
 	for (auto &a : allTables) {
-		if (a.second->getFileType () == "heap") {
+		if (a.second->getFileType () == "heap" || a.second->getFileType () == "pax") {
 			allTableReaderWriters[a.first] =  make_shared <MyDB_TableReaderWriter> (a.second, myMgr);
 		} else if (a.second->getFileType () == "bplustree") {
+			myMgr->setPool (a.second, "index");
 			allBPlusReaderWriters[a.first] = make_shared <MyDB_BPlusTreeReaderWriter> (a.second->getSortAtt (), a.second, myMgr);
 			allTableReaderWriters[a.first] = allBPlusReaderWriters[a.first];	
 		}
@@ -82,13 +110,23 @@ int main (int numArgs, char **args) {
 				// see if we got a "quit" or "exit"
 				if (tokens.size () == 1 && (toLower (tokens[0]) == "exit" || toLower (tokens[0]) == "quit")) {
 					cout << "OK, goodbye.\n";
-					// before we get outta here, write everything into the catalog
+					// before we get outta here, write everything into the catalog, and get
+					// the tables and the catalog to disk, so the log can start over
 					for (auto &a : allTables) {
 						a.second->putInCatalog (myCatalog);
 					}
+					myLog->checkpoint (*myMgr, myCatalog);
 					return 0;
 				}
 
+				// see if we got a "resize buffer to numpages"
+				if (tokens.size () == 4 && toLower (tokens[0]) == "resize" && toLower (tokens[1]) == "buffer" && 
+					toLower (tokens[2]) == "to") {
+					size_t newNumPages = myMgr->resize (strtoul (tokens[3].c_str (), nullptr, 10));
+					cout << "OK, the buffer now has " << newNumPages << " pages (" << newNumPages * pageSize / (1024 * 1024) << "MB).\n";
+					break;
+				}
+
 				// see if we got a "load soandso from afile"
 				if (tokens.size () == 4 && toLower(tokens[0]) == "load" && toLower(tokens[2]) == "from") {
 
@@ -105,6 +143,10 @@ int main (int numArgs, char **args) {
 						// and record the tuple various counts
 						allTableReaderWriters[tokens[1]]->getTable ()->setDistinctValues (res.first);
 						allTableReaderWriters[tokens[1]]->getTable ()->setTupleCount (res.second);
+
+						// and make the load durable
+						allTableReaderWriters[tokens[1]]->getTable ()->putInCatalog (myCatalog);
+						myLog->commit ();
 						break;
 					}
 				}
@@ -157,6 +199,7 @@ int main (int numArgs, char **args) {
 								allTableReaderWriters[tableName] = allBPlusReaderWriters[tableName];
 							}
 							cout << "Added table " << final->addToCatalog (args[2], myCatalog) << "\n";
+							myLog->commit ();
 						}	
 
 					} else if (final->isSFWQuery ()) {
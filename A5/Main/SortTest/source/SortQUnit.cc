@@ -13,6 +13,7 @@
 #include "MyDB_Schema.h"
 #include "QUnit.h"
 #include "Sorting.h"
+#include <cstring>
 #include <iostream>
 
 int main () {
@@ -110,6 +111,96 @@ int main () {
 
 	}
 
+	{
+		// load up the table supplier table from the catalog
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+
+		// copy the 37th page onto a slotted page
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr temp2 = supplierTable.getEmptyRecord ();
+		MyDB_PageReaderWriter slotted (true, *myMgr);
+		slotted.clear (MyDB_PageType :: SlottedPage);
+		MyDB_RecordIteratorPtr myIter = supplierTable[36].getIterator (temp);
+		size_t numRecs = 0;
+		while (myIter->hasNext ()) {
+			myIter->getNext ();
+			if (slotted.append (temp))
+				numRecs++;
+		}
+		QUNIT_IS_EQUAL (slotted.getNumRecords (), numRecs);
+
+		// sort it in place... the slots should then be in order
+		function <bool ()> myComp = buildRecordComparator (temp, temp2, "[acctbal]");
+		slotted.sortInPlace (myComp, temp, temp2);
+		bool inOrder = true;
+		for (size_t k = 1; k < numRecs; k++) {
+			slotted.getRecord (k - 1, temp2);
+			slotted.getRecord (k, temp);
+			if (myComp ())
+				inOrder = false;
+		}
+		QUNIT_IS_TRUE (inOrder);
+
+		// and the iterator should go through them in that order as well
+		MyDB_RecordIteratorAltPtr myIterAlt = slotted.getIteratorAlt ();
+		size_t counter = 0;
+		while (myIterAlt->advance ()) {
+			myIterAlt->getCurrent (temp);
+			slotted.getRecord (counter, temp2);
+			if (myComp ())
+				inOrder = false;
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, numRecs);
+		QUNIT_IS_TRUE (inOrder);
+
+		// search for the key of the record in the middle of the page
+		slotted.getRecord (numRecs / 2, temp2);
+		size_t low = slotted.lowerBound (myComp, temp, temp2);
+		slotted.getRecord (numRecs / 2, temp);
+		size_t high = slotted.upperBound (myComp, temp, temp2);
+		QUNIT_IS_TRUE (low <= numRecs / 2 && numRecs / 2 < high);
+		if (low > 0) {
+			slotted.getRecord (low - 1, temp);
+			QUNIT_IS_TRUE (myComp ());
+		}
+		if (high < numRecs) {
+			slotted.getRecord (high, temp2);
+			QUNIT_IS_TRUE (myComp ());
+		}
+
+		// the runs of a sort with a predicate are slotted pages, sorted in place... the sort
+		// uses temp and temp2, so the output is checked with two other records
+		MyDB_RecordPtr cur = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr last = supplierTable.getEmptyRecord ();
+		function <bool ()> checkComp = buildRecordComparator (cur, last, "[acctbal]");
+		func pred = cur->compileComputation ("< ([nationkey], int[5])");
+		int numPassed = 0;
+		MyDB_RecordIteratorAltPtr scan = supplierTable.getIteratorAlt ();
+		while (scan->advance ()) {
+			scan->getCurrent (cur);
+			if (pred ()->toBool ())
+				numPassed++;
+		}
+		MyDB_RecordIteratorAltPtr sortedIter = buildItertorOverSortedRuns (8, supplierTable, myComp, temp, temp2,
+			"< ([nationkey], int[5])");
+		int numSorted = 0;
+		bool first = true;
+		while (sortedIter->advance ()) {
+			sortedIter->getCurrent (cur);
+			if (!pred ()->toBool () || (!first && checkComp ()))
+				inOrder = false;
+			sortedIter->getCurrent (last);
+			first = false;
+			numSorted++;
+		}
+		QUNIT_IS_EQUAL (numSorted, numPassed);
+		QUNIT_IS_TRUE (inOrder);
+	}
+
 	{
 		// load up the table supplier table from the catalog
 		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
@@ -192,6 +283,34 @@ int main () {
 
                 QUNIT_IS_EQUAL (matches, 320000);
 	}
+
+	{
+		// records that are views of the pages that a scan keeps pinned
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_RecordPtr view = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr copy = supplierTable.getEmptyRecord ();
+
+		// a view has the same contents as a copy, and is written out the same way
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+		vector <char> viewBytes (1024), copyBytes (1024);
+		int counter = 0, matches = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrentView (view);
+			myIter->getCurrent (copy);
+			view->toBinary (viewBytes.data ());
+			copy->toBinary (copyBytes.data ());
+			if (view->getAtt (6)->toString () == copy->getAtt (6)->toString () &&
+				view->getBinarySize () == copy->getBinarySize () &&
+				memcmp (viewBytes.data (), copyBytes.data (), copy->getBinarySize ()) == 0)
+				matches++;
+			counter++;
+		}
+		QUNIT_IS_EQUAL (counter, 320000);
+		QUNIT_IS_EQUAL (matches, 320000);
+	}
 }
 
 #endif
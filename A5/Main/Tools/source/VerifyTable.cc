@@ -0,0 +1,73 @@
+
+#ifndef VERIFY_TABLE_C
+#define VERIFY_TABLE_C
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include "MyDB_Checksum.h"
+#include "MyDB_FileIO.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// checks the checksum of every page of a table file (see MyDB_BufferManager :: setPageChecksums)
+// by reading the file directly, so it can be run on a database that is not up.  Pages that
+// were written without checksums (or never written at all) are counted, but cannot be checked.
+// Prints every bad page, and exits with status 1 if there are any (or if the file ends in
+// part of a page).  The default page size is
+// the one used by the SQL front end.
+// Usage: verifyTable file.bin [pageSize]
+int main (int argc, char *argv[]) {
+
+	if (argc < 2) {
+		cout << "Usage: verifyTable file.bin [pageSize]\n";
+		return 2;
+	}
+	string fName = argv[1];
+	size_t pageSize = 131072;
+	if (argc > 2)
+		pageSize = atoi (argv[2]);
+	if (pageSize < PAGE_CHECKSUM_OFFSET + sizeof (uint32_t)) {
+		cout << "A page size of " << pageSize << " is too small to hold a checksum.\n";
+		return 2;
+	}
+
+	int fd = open (fName.c_str (), O_RDONLY);
+	struct stat info;
+	if (fd == -1 || fstat (fd, &info) != 0) {
+		cout << "Can't open " << fName << ": " << lastIOError () << "\n";
+		return 2;
+	}
+
+	size_t numPages = info.st_size / pageSize;
+	size_t numChecked = 0, numUnchecked = 0, numBad = 0;
+	vector <char> page (pageSize);
+	for (size_t i = 0; i < numPages; i++) {
+		if (!readFully (fd, page.data (), pageSize, i * pageSize)) {
+			cout << "Can't read page " << i << " of " << fName << ": " << lastIOError () << "\n";
+			return 2;
+		}
+		if (storedChecksum (page.data ()) == 0) {
+			numUnchecked++;
+		} else if (pageChecksumOK (page.data (), pageSize)) {
+			numChecked++;
+		} else {
+			cout << "page " << i << ": stored checksum " << storedChecksum (page.data ()) << ", contents add up to "
+				<< pageChecksum (page.data (), pageSize) << "\n";
+			numBad++;
+		}
+	}
+	close (fd);
+
+	cout << fName << ": " << numPages << " pages of " << pageSize << " bytes; " << numChecked << " good, " << numBad
+		<< " bad, " << numUnchecked << " without a checksum";
+	if (info.st_size % pageSize != 0)
+		cout << "; plus " << info.st_size % pageSize << " bytes of a partial page at the end (a torn append?)";
+	cout << "\n";
+	return (numBad > 0 || info.st_size % pageSize != 0) ? 1 : 0;
+}
+
+#endif